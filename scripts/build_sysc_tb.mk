@@ -13,10 +13,13 @@ SRC_DIR      ?= src/cxx/
 
 TARGET       ?= test.x
 
+GIT_HASH     ?= $(shell git rev-parse --short HEAD 2>/dev/null || echo unknown)
+
 # Additional include directories
 INCLUDE_PATH ?=
 INCLUDE_PATH += $(SRC_DIR)
 INCLUDE_PATH += build/verilated
+INCLUDE_PATH += build/rtl
 INCLUDE_PATH += $(VERILATOR_SRC)
 INCLUDE_PATH += $(VERILATOR_SRC)/vltstd
 INCLUDE_PATH += $(SYSTEMC_HOME)/include
@@ -31,6 +34,9 @@ CFLAGS       ?= -fpic -O2
 CFLAGS       += $(patsubst %,-I%,$(INCLUDE_PATH))
 CFLAGS       += -DVM_TRACE=1
 CFLAGS       += $(BUS_CFLAGS)
+CFLAGS       += -DGIT_HASH=\"$(GIT_HASH)\"
+# Header dependencies (sdram_params.h changes with the elaboration)
+CFLAGS       += -MMD -MP
 LDFLAGS      ?= -O2
 LDFLAGS      += -L$(SYSTEMC_LIBDIR) 
 LDFLAGS      += $(patsubst %,-L%,$(LIB_PATH))
@@ -71,5 +77,7 @@ $(foreach src,$(SRC_C),$(eval $(call template_c,$(src))))
 $(EXE_DIR)$(TARGET): $(OBJ) | $(EXE_DIR) 
 	$(CXX) $(LDFLAGS) $(OBJ) -o $@ -lsystemc $(LIBS)
 
+-include $(OBJ:.o=.d)
+
 clean:
 	rm -rf $(EXE_DIR) $(OBJ_DIR) $(EXTRA_CLEAN_FILES)
@@ -1,6 +1,7 @@
 #ifndef AXI4_H
 #define AXI4_H
 
+#include "axi4_defines.h"
 #include <systemc.h>
 
 //----------------------------------------------------------------
@@ -15,8 +16,8 @@ public:
   sc_uint<8> AWLEN;
   sc_uint<2> AWBURST;
   sc_uint<1> WVALID;
-  sc_uint<32> WDATA;
-  sc_uint<4> WSTRB;
+  sc_uint<AXI4_DATA_W> WDATA;
+  sc_uint<AXI4_STRB_W> WSTRB;
   sc_uint<1> WLAST;
   sc_uint<1> BREADY;
   sc_uint<1> ARVALID;
@@ -148,7 +149,7 @@ public:
   sc_uint<4> BID;
   sc_uint<1> ARREADY;
   sc_uint<1> RVALID;
-  sc_uint<32> RDATA;
+  sc_uint<AXI4_DATA_W> RDATA;
   sc_uint<2> RRESP;
   sc_uint<4> RID;
   sc_uint<1> RLAST;
@@ -1,11 +1,23 @@
 #ifndef AXI4_DEFINES_H
 #define AXI4_DEFINES_H
 
+// AXI4_DATA_W as elaborated (see sdram_defines.h)
+#if __has_include("sdram_params.h")
+#include "sdram_params.h"
+#endif
+
 //--------------------------------------------------------------------
 // Defines
 //--------------------------------------------------------------------
 #define AXI4_ADDR_W 32
+// 32, or 64 with both chips in lock-step (SdramParams.lanes = 2)
+#ifndef AXI4_DATA_W
 #define AXI4_DATA_W 32
+#endif
+#define AXI4_STRB_W (AXI4_DATA_W / 8)
+#define AXI4_STRB_MASK ((1u << AXI4_STRB_W) - 1)
+// AxSIZE of a full beat (log2 bytes)
+#define AXI4_SIZE (AXI4_DATA_W == 64 ? 3 : 2)
 #define AXI4_AXLEN_W 8
 #define AXI4_AXBURST_W 2
 #define AXI4_RESP_W 2
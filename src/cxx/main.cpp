@@ -7,15 +7,20 @@
 //--------------------------------------------------------------------
 // Defines
 //--------------------------------------------------------------------
+// ps resolution: 133 MHz is a 7.5 ns clock
 #ifndef SIM_TIME_RESOLUTION
 #define SIM_TIME_RESOLUTION 1
 #endif
+#ifndef SIM_TIME_RESOLUTION_SCALE
+#define SIM_TIME_RESOLUTION_SCALE SC_PS
+#endif
 #ifndef SIM_TIME_SCALE
 #define SIM_TIME_SCALE SC_NS
 #endif
 
+// Clock the RTL was elaborated for (SdramParams.mhz)
 #ifndef CLK0_PERIOD
-#define CLK0_PERIOD 10
+#define CLK0_PERIOD (1000.0 / SDRAM_MHZ)
 #endif
 
 #ifndef CLK0_NAME
@@ -72,6 +77,7 @@ int sc_main(int argc, char *argv[]) {
   int seed = 1;
   bool delays = true;
   int testcase = -1;
+  const char *bench = NULL;
   int last_argc = 0;
 
   // Env variable seed override
@@ -95,6 +101,9 @@ int sc_main(int argc, char *argv[]) {
     } else if (!strcmp(argv[i], "--delays")) {
       delays = strtol(argv[i + 1], NULL, 0);
       i++;
+    } else if (!strcmp(argv[i], "--bench")) {
+      bench = argv[i + 1];
+      i++;
     } else {
       last_argc = i - 1;
       break;
@@ -107,7 +116,7 @@ int sc_main(int argc, char *argv[]) {
     trace = 0;
 
   sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", SC_DO_NOTHING);
-  sc_set_time_resolution(SIM_TIME_RESOLUTION, SIM_TIME_SCALE);
+  sc_set_time_resolution(SIM_TIME_RESOLUTION, SIM_TIME_RESOLUTION_SCALE);
 
   // Register custom assert handler to print TEST: FAILED on fatal assertions...
   sc_report_handler::set_handler(assert_handler);
@@ -118,9 +127,6 @@ int sc_main(int argc, char *argv[]) {
   // Catch SIGINT to restore terminal settings on exit
   signal(SIGINT, sigint_handler);
 
-  // Seed
-  srand(seed);
-
   // Clocks
   sc_clock CLK0_NAME(xstr(CLK0_NAME), CLK0_PERIOD, SIM_TIME_SCALE);
   sc_reset_gen clk0_rst(xstr(RST0_NAME));
@@ -143,6 +149,9 @@ int sc_main(int argc, char *argv[]) {
   tb->set_iterations(iterations);
   tb->set_delays(delays);
   tb->set_testcase(testcase);
+  tb->set_seed(seed);
+  if (bench)
+    tb->set_bench(bench);
   tb->set_argcv(argc - last_argc, &argv[last_argc]);
 
   // Complete elaboration before enabling tracing (required by SystemC 3.x)
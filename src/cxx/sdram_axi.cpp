@@ -1,5 +1,6 @@
 #include "sdram_axi.h"
 #include "VSDRAMAxiSimTop.h"
+#include "tb_sim_profile.h"
 
 #if VM_TRACE
 #include "verilated.h"
@@ -54,6 +55,54 @@ sdram_axi::sdram_axi(sc_module_name name) : sc_module(name) {
   m_rtl->in_r_bits_id(m_in_r_bits_id);
   m_rtl->in_r_bits_last(m_in_r_bits_last);
 
+  // SDRAM command bus (observation only)
+  m_rtl->sdram0_clk(m_sdram0_clk);
+  m_rtl->sdram0_cke(m_sdram0_cke);
+  m_rtl->sdram0_cs(m_sdram0_cs);
+  m_rtl->sdram0_ras(m_sdram0_ras);
+  m_rtl->sdram0_cas(m_sdram0_cas);
+  m_rtl->sdram0_we(m_sdram0_we);
+  m_rtl->sdram0_addr(m_sdram0_addr);
+  m_rtl->sdram0_ba(m_sdram0_ba);
+  m_rtl->sdram0_dqm(m_sdram0_dqm);
+  m_rtl->sdram1_clk(m_sdram1_clk);
+  m_rtl->sdram1_cke(m_sdram1_cke);
+  m_rtl->sdram1_cs(m_sdram1_cs);
+  m_rtl->sdram1_ras(m_sdram1_ras);
+  m_rtl->sdram1_cas(m_sdram1_cas);
+  m_rtl->sdram1_we(m_sdram1_we);
+  m_rtl->sdram1_addr(m_sdram1_addr);
+  m_rtl->sdram1_ba(m_sdram1_ba);
+  m_rtl->sdram1_dqm(m_sdram1_dqm);
+
+  // Pmem queue occupancy (observation only)
+  m_rtl->debug_rDataCount(m_debug_rDataCount);
+  m_rtl->debug_wDataCount(m_debug_wDataCount);
+  m_rtl->debug_arCount(m_debug_arCount);
+  m_rtl->debug_awCount(m_debug_awCount);
+
+  // SdramCore state (observation only)
+  m_rtl->core0_state(m_core0_state);
+  m_rtl->core0_targetState(m_core0_targetState);
+  m_rtl->core0_delayState(m_core0_delayState);
+  m_rtl->core0_refresh(m_core0_refresh);
+  m_rtl->core0_bankWait(m_core0_bankWait);
+  m_rtl->core0_refreshOwed(m_core0_refreshOwed);
+  m_rtl->core1_state(m_core1_state);
+  m_rtl->core1_targetState(m_core1_targetState);
+  m_rtl->core1_delayState(m_core1_delayState);
+  m_rtl->core1_refresh(m_core1_refresh);
+  m_rtl->core1_bankWait(m_core1_bankWait);
+  m_rtl->core1_refreshOwed(m_core1_refreshOwed);
+
+  // Arbitration / ack ordering (observation only)
+  m_rtl->debug_rArbLoss(m_debug_rArbLoss);
+  m_rtl->debug_wArbLoss(m_debug_wArbLoss);
+  m_rtl->debug_rTurnaround(m_debug_rTurnaround);
+  m_rtl->debug_wTurnaround(m_debug_wTurnaround);
+  m_rtl->pending_valid(m_pending_valid);
+  m_rtl->pending_chip(m_pending_chip);
+
   SC_METHOD(async_outputs);
   sensitive << clk_in;
   sensitive << rst_in;
@@ -69,6 +118,44 @@ sdram_axi::sdram_axi(sc_module_name name) : sc_module(name) {
   sensitive << m_in_r_bits_resp;
   sensitive << m_in_r_bits_id;
   sensitive << m_in_r_bits_last;
+  sensitive << m_sdram0_cke;
+  sensitive << m_sdram0_cs;
+  sensitive << m_sdram0_ras;
+  sensitive << m_sdram0_cas;
+  sensitive << m_sdram0_we;
+  sensitive << m_sdram0_addr;
+  sensitive << m_sdram0_ba;
+  sensitive << m_sdram0_dqm;
+  sensitive << m_sdram1_cke;
+  sensitive << m_sdram1_cs;
+  sensitive << m_sdram1_ras;
+  sensitive << m_sdram1_cas;
+  sensitive << m_sdram1_we;
+  sensitive << m_sdram1_addr;
+  sensitive << m_sdram1_ba;
+  sensitive << m_sdram1_dqm;
+  sensitive << m_debug_rDataCount;
+  sensitive << m_debug_wDataCount;
+  sensitive << m_debug_arCount;
+  sensitive << m_debug_awCount;
+  sensitive << m_core0_state;
+  sensitive << m_core0_targetState;
+  sensitive << m_core0_delayState;
+  sensitive << m_core0_refresh;
+  sensitive << m_core0_bankWait;
+  sensitive << m_core0_refreshOwed;
+  sensitive << m_core1_state;
+  sensitive << m_core1_targetState;
+  sensitive << m_core1_delayState;
+  sensitive << m_core1_refresh;
+  sensitive << m_core1_bankWait;
+  sensitive << m_core1_refreshOwed;
+  sensitive << m_debug_rArbLoss;
+  sensitive << m_debug_wArbLoss;
+  sensitive << m_debug_rTurnaround;
+  sensitive << m_debug_wTurnaround;
+  sensitive << m_pending_valid;
+  sensitive << m_pending_chip;
 
 #if VM_TRACE
   m_vcd = NULL;
@@ -95,6 +182,8 @@ void sdram_axi::trace_enable(VerilatedVcdSc *p, sc_core::sc_time start_time) {
 // async_outputs
 //-------------------------------------------------------------
 void sdram_axi::async_outputs(void) {
+  tb_prof_scope prof(TB_PROF_DUT_WRAPPER);
+
   m_clk_in.write(clk_in.read());
   m_rst_in.write(rst_in.read());
 
@@ -106,7 +195,7 @@ void sdram_axi::async_outputs(void) {
   m_in_aw_bits_id.write(inport_i.AWID);
   m_in_aw_bits_len.write(inport_i.AWLEN);
   m_in_aw_bits_burst.write(inport_i.AWBURST);
-  m_in_aw_bits_size.write(2);
+  m_in_aw_bits_size.write(AXI4_SIZE);
   // W channel
   m_in_w_valid.write(inport_i.WVALID);
   m_in_w_bits_data.write(inport_i.WDATA);
@@ -122,7 +211,7 @@ void sdram_axi::async_outputs(void) {
   m_in_ar_bits_id.write(inport_i.ARID);
   m_in_ar_bits_len.write(inport_i.ARLEN);
   m_in_ar_bits_burst.write(inport_i.ARBURST);
-  m_in_ar_bits_size.write(2);
+  m_in_ar_bits_size.write(AXI4_SIZE);
   // R channel
   m_in_r_ready.write(inport_i.RREADY);
 
@@ -140,4 +229,62 @@ void sdram_axi::async_outputs(void) {
   inport_o.RID = m_in_r_bits_id.read();
   inport_o.RLAST = m_in_r_bits_last.read();
   inport_out.write(inport_o);
+
+  // SDRAM command bus
+  sdram_io sdram0_o;
+  sdram0_o.CKE = m_sdram0_cke.read();
+  sdram0_o.CS = m_sdram0_cs.read();
+  sdram0_o.RAS = m_sdram0_ras.read();
+  sdram0_o.CAS = m_sdram0_cas.read();
+  sdram0_o.WE = m_sdram0_we.read();
+  sdram0_o.ADDR = m_sdram0_addr.read();
+  sdram0_o.BA = m_sdram0_ba.read();
+  sdram0_o.DQM = m_sdram0_dqm.read();
+  sdram0_out.write(sdram0_o);
+
+  sdram_io sdram1_o;
+  sdram1_o.CKE = m_sdram1_cke.read();
+  sdram1_o.CS = m_sdram1_cs.read();
+  sdram1_o.RAS = m_sdram1_ras.read();
+  sdram1_o.CAS = m_sdram1_cas.read();
+  sdram1_o.WE = m_sdram1_we.read();
+  sdram1_o.ADDR = m_sdram1_addr.read();
+  sdram1_o.BA = m_sdram1_ba.read();
+  sdram1_o.DQM = m_sdram1_dqm.read();
+  sdram1_out.write(sdram1_o);
+
+  // Pmem queue occupancy
+  rdata_level_out.write(m_debug_rDataCount.read());
+  wdata_level_out.write(m_debug_wDataCount.read());
+  ar_level_out.write(m_debug_arCount.read());
+  aw_level_out.write(m_debug_awCount.read());
+
+  // SdramCore state
+  sdram_core_debug core0_o;
+  core0_o.STATE = m_core0_state.read();
+  core0_o.TARGET = m_core0_targetState.read();
+  core0_o.DELAY_TARGET = m_core0_delayState.read();
+  core0_o.REFRESH = m_core0_refresh.read();
+  core0_o.BANK_WAIT = m_core0_bankWait.read();
+  core0_o.REFRESH_OWED = m_core0_refreshOwed.read();
+  core0_out.write(core0_o);
+
+  sdram_core_debug core1_o;
+  core1_o.STATE = m_core1_state.read();
+  core1_o.TARGET = m_core1_targetState.read();
+  core1_o.DELAY_TARGET = m_core1_delayState.read();
+  core1_o.REFRESH = m_core1_refresh.read();
+  core1_o.BANK_WAIT = m_core1_bankWait.read();
+  core1_o.REFRESH_OWED = m_core1_refreshOwed.read();
+  core1_out.write(core1_o);
+
+  // Arbitration / ack ordering
+  sdram_ctrl_debug ctrl_o;
+  ctrl_o.R_ARB_LOSS = m_debug_rArbLoss.read();
+  ctrl_o.W_ARB_LOSS = m_debug_wArbLoss.read();
+  ctrl_o.R_TURNAROUND = m_debug_rTurnaround.read();
+  ctrl_o.W_TURNAROUND = m_debug_wTurnaround.read();
+  ctrl_o.PENDING_VALID = m_pending_valid.read();
+  ctrl_o.PENDING_CHIP = m_pending_chip.read();
+  ctrl_out.write(ctrl_o);
 }
@@ -4,6 +4,7 @@
 #include <systemc.h>
 
 #include "axi4.h"
+#include "sdram_io.h"
 
 class VSDRAMAxiSimTop;
 
@@ -20,6 +21,23 @@ public:
   sc_in<axi4_master> inport_in;
   sc_out<axi4_slave> inport_out;
 
+  // Command bus of each chip (observation only)
+  sc_out<sdram_io> sdram0_out;
+  sc_out<sdram_io> sdram1_out;
+
+  // AXI front-end queue occupancy (observation only)
+  sc_out<sc_uint<8>> rdata_level_out;
+  sc_out<sc_uint<8>> wdata_level_out;
+  sc_out<sc_uint<8>> ar_level_out;
+  sc_out<sc_uint<8>> aw_level_out;
+
+  // SdramCore state of each chip (observation only)
+  sc_out<sdram_core_debug> core0_out;
+  sc_out<sdram_core_debug> core1_out;
+
+  // Arbitration / ack ordering state (observation only)
+  sc_out<sdram_ctrl_debug> ctrl_out;
+
   //-------------------------------------------------------------
   // Constructor
   //-------------------------------------------------------------
@@ -37,6 +55,15 @@ public:
     TRACE_SIGNAL(rst_in);
     TRACE_SIGNAL(inport_in);
     TRACE_SIGNAL(inport_out);
+    TRACE_SIGNAL(sdram0_out);
+    TRACE_SIGNAL(sdram1_out);
+    TRACE_SIGNAL(rdata_level_out);
+    TRACE_SIGNAL(wdata_level_out);
+    TRACE_SIGNAL(ar_level_out);
+    TRACE_SIGNAL(aw_level_out);
+    TRACE_SIGNAL(core0_out);
+    TRACE_SIGNAL(core1_out);
+    TRACE_SIGNAL(ctrl_out);
 
 #undef TRACE_SIGNAL
   }
@@ -63,8 +90,8 @@ private:
 
   // W channel
   sc_signal<bool> m_in_w_valid;
-  sc_signal<sc_uint<32>> m_in_w_bits_data;
-  sc_signal<sc_uint<4>> m_in_w_bits_strb;
+  sc_signal<sc_uint<AXI4_DATA_W>> m_in_w_bits_data;
+  sc_signal<sc_uint<AXI4_STRB_W>> m_in_w_bits_strb;
   sc_signal<bool> m_in_w_bits_last;
 
   // B channel
@@ -93,11 +120,61 @@ private:
   sc_signal<bool> m_in_ar_ready;
   // R channel
   sc_signal<bool> m_in_r_valid;
-  sc_signal<sc_uint<32>> m_in_r_bits_data;
+  sc_signal<sc_uint<AXI4_DATA_W>> m_in_r_bits_data;
   sc_signal<sc_uint<2>> m_in_r_bits_resp;
   sc_signal<sc_uint<4>> m_in_r_bits_id;
   sc_signal<bool> m_in_r_bits_last;
 
+  // SDRAM command bus (chip 0)
+  sc_signal<bool> m_sdram0_clk;
+  sc_signal<bool> m_sdram0_cke;
+  sc_signal<bool> m_sdram0_cs;
+  sc_signal<bool> m_sdram0_ras;
+  sc_signal<bool> m_sdram0_cas;
+  sc_signal<bool> m_sdram0_we;
+  sc_signal<sc_uint<SDRAM_ROW_W>> m_sdram0_addr;
+  sc_signal<sc_uint<SDRAM_BANK_W>> m_sdram0_ba;
+  sc_signal<sc_uint<SDRAM_DATA_W / 8>> m_sdram0_dqm;
+
+  // SDRAM command bus (chip 1)
+  sc_signal<bool> m_sdram1_clk;
+  sc_signal<bool> m_sdram1_cke;
+  sc_signal<bool> m_sdram1_cs;
+  sc_signal<bool> m_sdram1_ras;
+  sc_signal<bool> m_sdram1_cas;
+  sc_signal<bool> m_sdram1_we;
+  sc_signal<sc_uint<SDRAM_ROW_W>> m_sdram1_addr;
+  sc_signal<sc_uint<SDRAM_BANK_W>> m_sdram1_ba;
+  sc_signal<sc_uint<SDRAM_DATA_W / 8>> m_sdram1_dqm;
+
+  // Pmem queue occupancy
+  sc_signal<sc_uint<8>> m_debug_rDataCount;
+  sc_signal<sc_uint<8>> m_debug_wDataCount;
+  sc_signal<sc_uint<8>> m_debug_arCount;
+  sc_signal<sc_uint<8>> m_debug_awCount;
+
+  // SdramCore state
+  sc_signal<sc_uint<4>> m_core0_state;
+  sc_signal<sc_uint<4>> m_core0_targetState;
+  sc_signal<sc_uint<4>> m_core0_delayState;
+  sc_signal<bool> m_core0_refresh;
+  sc_signal<bool> m_core0_bankWait;
+  sc_signal<sc_uint<4>> m_core0_refreshOwed;
+  sc_signal<sc_uint<4>> m_core1_state;
+  sc_signal<sc_uint<4>> m_core1_targetState;
+  sc_signal<sc_uint<4>> m_core1_delayState;
+  sc_signal<bool> m_core1_refresh;
+  sc_signal<bool> m_core1_bankWait;
+  sc_signal<sc_uint<4>> m_core1_refreshOwed;
+
+  // Arbitration / ack ordering
+  sc_signal<bool> m_debug_rArbLoss;
+  sc_signal<bool> m_debug_wArbLoss;
+  sc_signal<bool> m_debug_rTurnaround;
+  sc_signal<bool> m_debug_wTurnaround;
+  sc_signal<bool> m_pending_valid;
+  sc_signal<bool> m_pending_chip;
+
 public:
   VSDRAMAxiSimTop *m_rtl;
 #if VM_TRACE
@@ -0,0 +1,191 @@
+#ifndef SDRAM_DEFINES_H
+#define SDRAM_DEFINES_H
+
+// SdramParams as elaborated (sdram.Elaborate writes it next to the RTL);
+// the defaults below only apply to a tree without one
+#if __has_include("sdram_params.h")
+#include "sdram_params.h"
+#endif
+
+//--------------------------------------------------------------------
+// Defines (must match SdramParams / SdramInterleaveTop)
+//--------------------------------------------------------------------
+#ifndef SDRAM_MHZ
+#define SDRAM_MHZ 50
+#endif
+#ifndef SDRAM_ADDR_W
+#define SDRAM_ADDR_W 24
+#endif
+#ifndef SDRAM_COL_W
+#define SDRAM_COL_W 9
+#endif
+#ifndef SDRAM_BANK_W
+#define SDRAM_BANK_W 2
+#endif
+#ifndef SDRAM_DATA_W
+#define SDRAM_DATA_W 16
+#endif
+// Mode register CL: 2, or 3 at 100 / 133 MHz
+#ifndef SDRAM_CAS_LATENCY
+#define SDRAM_CAS_LATENCY 2
+#endif
+#ifndef SDRAM_TRCD_NS
+#define SDRAM_TRCD_NS 20
+#endif
+#ifndef SDRAM_TRP_NS
+#define SDRAM_TRP_NS 20
+#endif
+#ifndef SDRAM_TRFC_NS
+#define SDRAM_TRFC_NS 60
+#endif
+#ifndef SDRAM_TRAS_NS
+#define SDRAM_TRAS_NS 42
+#endif
+#ifndef SDRAM_TWR_NS
+#define SDRAM_TWR_NS 12
+#endif
+#ifndef SDRAM_TRRD_NS
+#define SDRAM_TRRD_NS 12
+#endif
+
+// Two chips, selected by AXI address bit SdramParams.chipSelBit
+// (2 = word, 4 = 16 byte burst, 5 = 32 byte line interleave)
+#ifndef SDRAM_CHIPS
+#define SDRAM_CHIPS 2
+#endif
+#ifndef SDRAM_CHIP_SEL_BIT
+#define SDRAM_CHIP_SEL_BIT 2
+#endif
+
+// SdramParams.lanes: 2 = both chips in lock-step behind one core as a
+// single 2 x SDRAM_DATA_W device (64-bit AXI, no chip interleave)
+#ifndef SDRAM_LANES
+#define SDRAM_LANES 1
+#endif
+
+// SdramParams.bankRowCol: core address bank | row | col (0: row | bank
+// | col)
+#ifndef SDRAM_BANK_ROW_COL
+#define SDRAM_BANK_ROW_COL 0
+#endif
+
+// SdramParams.bankXor: bank = bank bits ^ low row bits
+#ifndef SDRAM_BANK_XOR
+#define SDRAM_BANK_XOR 0
+#endif
+
+#define SDRAM_ROW_W (SDRAM_ADDR_W - SDRAM_COL_W - SDRAM_BANK_W)
+#define SDRAM_BANKS (1 << SDRAM_BANK_W)
+#define SDRAM_ROWS (1 << SDRAM_ROW_W)
+
+// SdramAxiPmem wDataQueue depth
+#ifndef SDRAM_PMEM_QUEUE_DEPTH
+#define SDRAM_PMEM_QUEUE_DEPTH 4
+#endif
+
+// SdramParams.readDepth: read words in flight, rDataQ depth (rDataDepth,
+// or casLatency + 6: grant -> R latency plus the cycle a slot takes to free)
+#ifndef SDRAM_PMEM_READ_DEPTH
+#define SDRAM_PMEM_READ_DEPTH (SDRAM_CAS_LATENCY + 6)
+#endif
+
+// SdramParams.arQueueDepth (0 = one read burst at a time)
+#ifndef SDRAM_PMEM_AR_DEPTH
+#define SDRAM_PMEM_AR_DEPTH 2
+#endif
+
+// SdramParams.awQueueDepth (0 = one write burst at a time)
+#ifndef SDRAM_PMEM_AW_DEPTH
+#define SDRAM_PMEM_AW_DEPTH 2
+#endif
+
+// SdramParams.rwBatch (0 = read / write alternate per request)
+#ifndef SDRAM_PMEM_RW_BATCH
+#define SDRAM_PMEM_RW_BATCH 16
+#endif
+
+// SdramParams.refreshPostpone: REFs owed before one is forced
+#ifndef SDRAM_REFRESH_POSTPONE
+#define SDRAM_REFRESH_POSTPONE 8
+#endif
+
+// SdramParams.pagePolicy: 0 = open, 1 = closed, 2 = adaptive
+#ifndef SDRAM_PAGE_POLICY
+#define SDRAM_PAGE_POLICY 2
+#endif
+
+// SdramParams.streamDepth: requests buffered per chip in
+// SdramInterleaveTop ahead of the core queue
+#ifndef SDRAM_STREAM_DEPTH
+#define SDRAM_STREAM_DEPTH 4
+#endif
+
+// SdramParams.orderDepth: requests in flight over both chips (response
+// reorder queue), also the SdramAxiPmem write in flight cap
+#ifndef SDRAM_ORDER_DEPTH
+#define SDRAM_ORDER_DEPTH 16
+#endif
+
+// SdramParams.coreQueueDepth: requests queued per SdramCore, whose
+// rows the bank scheduler opens ahead
+#ifndef SDRAM_CORE_QUEUE_DEPTH
+#define SDRAM_CORE_QUEUE_DEPTH 2
+#endif
+
+// SdramCore power-up sequence length (startDelay + 100), plus margin
+#define SDRAM_INIT_CYCLES ((100 * SDRAM_MHZ) + 100 + 16)
+
+// SdramParams.burstLen: mode register BL (sequential), beats per RD / WR
+// unless cut short by BST or the next RD / WR
+#ifndef SDRAM_BURST_LEN
+#define SDRAM_BURST_LEN 8
+#endif
+#define SDRAM_AUTO_PRECHARGE_BIT 10
+
+// Core address layout: row | bank | word column | byte, or
+// bank | row | word column | byte; a word is two beats of the device
+#define SDRAM_WORD_BYTES (4 * SDRAM_LANES)
+#define SDRAM_CORE_COL_LSB (SDRAM_LANES > 1 ? 3 : 2)
+#define SDRAM_CORE_COL_W (SDRAM_COL_W - 1)
+#if SDRAM_BANK_ROW_COL
+#define SDRAM_CORE_ROW_LSB (SDRAM_CORE_COL_LSB + SDRAM_CORE_COL_W)
+#define SDRAM_CORE_BANK_LSB (SDRAM_CORE_ROW_LSB + SDRAM_ROW_W)
+#else
+#define SDRAM_CORE_BANK_LSB (SDRAM_CORE_COL_LSB + SDRAM_CORE_COL_W)
+#define SDRAM_CORE_ROW_LSB (SDRAM_CORE_BANK_LSB + SDRAM_BANK_W)
+#endif
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+// Decoded {cs_n, ras_n, cas_n, we_n}
+enum eSDRAM_CMD {
+  SDRAM_CMD_NOP, // Also deselect (cs_n high)
+  SDRAM_CMD_ACTIVE,
+  SDRAM_CMD_READ,
+  SDRAM_CMD_WRITE,
+  SDRAM_CMD_TERMINATE,
+  SDRAM_CMD_PRECHARGE,
+  SDRAM_CMD_REFRESH,
+  SDRAM_CMD_LOAD_MODE,
+  SDRAM_CMD_MAX
+};
+
+// SdramCore State (ChiselEnum order)
+enum eSDRAM_CORE_STATE {
+  SDRAM_STATE_INIT,
+  SDRAM_STATE_DELAY,
+  SDRAM_STATE_IDLE,
+  SDRAM_STATE_ACTIVATE, // Unused, the bank scheduler opens rows
+  SDRAM_STATE_READ,
+  SDRAM_STATE_READ_WAIT,
+  SDRAM_STATE_WRITE0,
+  SDRAM_STATE_WRITE1,
+  SDRAM_STATE_PRECHARGE,
+  SDRAM_STATE_REFRESH,
+  SDRAM_STATE_READ_BURST,
+  SDRAM_STATE_WRITE_BURST,
+  SDRAM_STATE_MAX
+};
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef SDRAM_IO_H
+#define SDRAM_IO_H
+
+#include <systemc.h>
+
+#include "sdram_defines.h"
+
+//----------------------------------------------------------------
+// Interface (SDRAM command bus, as seen at the chip pins)
+//----------------------------------------------------------------
+class sdram_io {
+public:
+  // Members
+  sc_uint<1> CKE;
+  sc_uint<1> CS;
+  sc_uint<1> RAS;
+  sc_uint<1> CAS;
+  sc_uint<1> WE;
+  sc_uint<SDRAM_ROW_W> ADDR;
+  sc_uint<SDRAM_BANK_W> BA;
+  sc_uint<SDRAM_DATA_W / 8> DQM;
+
+  // Construction
+  sdram_io() { init(); }
+
+  void init(void) {
+    CKE = 0;
+    CS = 1;
+    RAS = 1;
+    CAS = 1;
+    WE = 1;
+    ADDR = 0;
+    BA = 0;
+    DQM = 0;
+  }
+
+  // Decode the (active low) control pins
+  int command(void) const {
+    if (CS)
+      return SDRAM_CMD_NOP;
+
+    switch ((RAS << 2) | (CAS << 1) | WE) {
+    case 0:
+      return SDRAM_CMD_LOAD_MODE;
+    case 1:
+      return SDRAM_CMD_REFRESH;
+    case 2:
+      return SDRAM_CMD_PRECHARGE;
+    case 3:
+      return SDRAM_CMD_ACTIVE;
+    case 4:
+      return SDRAM_CMD_WRITE;
+    case 5:
+      return SDRAM_CMD_READ;
+    case 6:
+      return SDRAM_CMD_TERMINATE;
+    default:
+      return SDRAM_CMD_NOP;
+    }
+  }
+
+  static const char *command_name(int cmd) {
+    switch (cmd) {
+    case SDRAM_CMD_ACTIVE:
+      return "ACT";
+    case SDRAM_CMD_READ:
+      return "RD";
+    case SDRAM_CMD_WRITE:
+      return "WR";
+    case SDRAM_CMD_TERMINATE:
+      return "BST";
+    case SDRAM_CMD_PRECHARGE:
+      return "PRE";
+    case SDRAM_CMD_REFRESH:
+      return "REF";
+    case SDRAM_CMD_LOAD_MODE:
+      return "MRS";
+    default:
+      return "NOP";
+    }
+  }
+
+  bool operator==(const sdram_io &v) const {
+    bool eq = true;
+    eq &= (CKE == v.CKE);
+    eq &= (CS == v.CS);
+    eq &= (RAS == v.RAS);
+    eq &= (CAS == v.CAS);
+    eq &= (WE == v.WE);
+    eq &= (ADDR == v.ADDR);
+    eq &= (BA == v.BA);
+    eq &= (DQM == v.DQM);
+    return eq;
+  }
+
+  friend void sc_trace(sc_trace_file *tf, const sdram_io &v,
+                       const std::string &path) {
+    sc_trace(tf, v.CKE, path + "/cke");
+    sc_trace(tf, v.CS, path + "/cs");
+    sc_trace(tf, v.RAS, path + "/ras");
+    sc_trace(tf, v.CAS, path + "/cas");
+    sc_trace(tf, v.WE, path + "/we");
+    sc_trace(tf, v.ADDR, path + "/addr");
+    sc_trace(tf, v.BA, path + "/ba");
+    sc_trace(tf, v.DQM, path + "/dqm");
+  }
+
+  friend ostream &operator<<(ostream &os, sdram_io const &v) {
+    os << hex << "CKE: " << v.CKE << " ";
+    os << hex << "CS: " << v.CS << " ";
+    os << hex << "RAS: " << v.RAS << " ";
+    os << hex << "CAS: " << v.CAS << " ";
+    os << hex << "WE: " << v.WE << " ";
+    os << hex << "ADDR: " << v.ADDR << " ";
+    os << hex << "BA: " << v.BA << " ";
+    os << hex << "DQM: " << v.DQM << " ";
+    return os;
+  }
+
+  friend istream &operator>>(istream &is, sdram_io &val) {
+    // Not implemented
+    return is;
+  }
+};
+
+//----------------------------------------------------------------
+// Interface (SdramCore internal state, observation only)
+//----------------------------------------------------------------
+class sdram_core_debug {
+public:
+  // Members
+  sc_uint<4> STATE;
+  sc_uint<4> TARGET;       // REFRESH while refresh is pending / running
+  sc_uint<4> DELAY_TARGET; // State after the current delay
+  sc_uint<1> REFRESH;      // Refresh requested
+  sc_uint<1> BANK_WAIT;    // Queue head waiting for its bank (ACT / PRE)
+  sc_uint<4> REFRESH_OWED; // Refreshes due but not yet issued
+
+  // Construction
+  sdram_core_debug() { init(); }
+
+  void init(void) {
+    STATE = SDRAM_STATE_INIT;
+    TARGET = SDRAM_STATE_IDLE;
+    DELAY_TARGET = SDRAM_STATE_IDLE;
+    REFRESH = 0;
+    BANK_WAIT = 0;
+    REFRESH_OWED = 0;
+  }
+
+  static const char *state_name(int state) {
+    switch (state) {
+    case SDRAM_STATE_INIT:
+      return "init";
+    case SDRAM_STATE_DELAY:
+      return "delay";
+    case SDRAM_STATE_IDLE:
+      return "idle";
+    case SDRAM_STATE_ACTIVATE:
+      return "activate";
+    case SDRAM_STATE_READ:
+      return "read";
+    case SDRAM_STATE_READ_WAIT:
+      return "read_wait";
+    case SDRAM_STATE_WRITE0:
+      return "write0";
+    case SDRAM_STATE_WRITE1:
+      return "write1";
+    case SDRAM_STATE_PRECHARGE:
+      return "precharge";
+    case SDRAM_STATE_REFRESH:
+      return "refresh";
+    case SDRAM_STATE_READ_BURST:
+      return "read_burst";
+    case SDRAM_STATE_WRITE_BURST:
+      return "write_burst";
+    default:
+      return "unknown";
+    }
+  }
+
+  bool operator==(const sdram_core_debug &v) const {
+    bool eq = true;
+    eq &= (STATE == v.STATE);
+    eq &= (TARGET == v.TARGET);
+    eq &= (DELAY_TARGET == v.DELAY_TARGET);
+    eq &= (REFRESH == v.REFRESH);
+    eq &= (BANK_WAIT == v.BANK_WAIT);
+    eq &= (REFRESH_OWED == v.REFRESH_OWED);
+    return eq;
+  }
+
+  friend void sc_trace(sc_trace_file *tf, const sdram_core_debug &v,
+                       const std::string &path) {
+    sc_trace(tf, v.STATE, path + "/state");
+    sc_trace(tf, v.TARGET, path + "/target");
+    sc_trace(tf, v.DELAY_TARGET, path + "/delay_target");
+    sc_trace(tf, v.REFRESH, path + "/refresh");
+    sc_trace(tf, v.BANK_WAIT, path + "/bank_wait");
+    sc_trace(tf, v.REFRESH_OWED, path + "/refresh_owed");
+  }
+
+  friend ostream &operator<<(ostream &os, sdram_core_debug const &v) {
+    os << hex << "STATE: " << v.STATE << " ";
+    os << hex << "TARGET: " << v.TARGET << " ";
+    os << hex << "DELAY_TARGET: " << v.DELAY_TARGET << " ";
+    os << hex << "REFRESH: " << v.REFRESH << " ";
+    os << hex << "BANK_WAIT: " << v.BANK_WAIT << " ";
+    os << hex << "REFRESH_OWED: " << v.REFRESH_OWED << " ";
+    return os;
+  }
+
+  friend istream &operator>>(istream &is, sdram_core_debug &val) {
+    // Not implemented
+    return is;
+  }
+};
+
+//----------------------------------------------------------------
+// Interface (AXI front-end / chip interleave state, observation only)
+//----------------------------------------------------------------
+class sdram_ctrl_debug {
+public:
+  // Members
+  sc_uint<1> R_ARB_LOSS;    // Read request, write granted
+  sc_uint<1> W_ARB_LOSS;    // Write request, read granted
+  sc_uint<1> R_TURNAROUND;  // Read request held for write acks
+  sc_uint<1> W_TURNAROUND;  // Write request held for read acks
+  sc_uint<1> PENDING_VALID; // Response reorder queue not empty
+  sc_uint<1> PENDING_CHIP;  // Chip of the oldest outstanding request
+
+  // Construction
+  sdram_ctrl_debug() { init(); }
+
+  void init(void) {
+    R_ARB_LOSS = 0;
+    W_ARB_LOSS = 0;
+    R_TURNAROUND = 0;
+    W_TURNAROUND = 0;
+    PENDING_VALID = 0;
+    PENDING_CHIP = 0;
+  }
+
+  bool operator==(const sdram_ctrl_debug &v) const {
+    bool eq = true;
+    eq &= (R_ARB_LOSS == v.R_ARB_LOSS);
+    eq &= (W_ARB_LOSS == v.W_ARB_LOSS);
+    eq &= (R_TURNAROUND == v.R_TURNAROUND);
+    eq &= (W_TURNAROUND == v.W_TURNAROUND);
+    eq &= (PENDING_VALID == v.PENDING_VALID);
+    eq &= (PENDING_CHIP == v.PENDING_CHIP);
+    return eq;
+  }
+
+  friend void sc_trace(sc_trace_file *tf, const sdram_ctrl_debug &v,
+                       const std::string &path) {
+    sc_trace(tf, v.R_ARB_LOSS, path + "/r_arb_loss");
+    sc_trace(tf, v.W_ARB_LOSS, path + "/w_arb_loss");
+    sc_trace(tf, v.R_TURNAROUND, path + "/r_turnaround");
+    sc_trace(tf, v.W_TURNAROUND, path + "/w_turnaround");
+    sc_trace(tf, v.PENDING_VALID, path + "/pending_valid");
+    sc_trace(tf, v.PENDING_CHIP, path + "/pending_chip");
+  }
+
+  friend ostream &operator<<(ostream &os, sdram_ctrl_debug const &v) {
+    os << hex << "R_ARB_LOSS: " << v.R_ARB_LOSS << " ";
+    os << hex << "W_ARB_LOSS: " << v.W_ARB_LOSS << " ";
+    os << hex << "R_TURNAROUND: " << v.R_TURNAROUND << " ";
+    os << hex << "W_TURNAROUND: " << v.W_TURNAROUND << " ";
+    os << hex << "PENDING_VALID: " << v.PENDING_VALID << " ";
+    os << hex << "PENDING_CHIP: " << v.PENDING_CHIP << " ";
+    return os;
+  }
+
+  friend istream &operator>>(istream &is, sdram_ctrl_debug &val) {
+    // Not implemented
+    return is;
+  }
+};
+
+#endif
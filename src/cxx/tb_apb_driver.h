@@ -3,6 +3,7 @@
 
 #include "apb.h"
 #include "tb_driver_api.h"
+#include "tb_rand.h"
 
 //-------------------------------------------------------------
 // tb_apb_driver: APB4 driver interface
@@ -22,6 +23,7 @@ public:
   tb_apb_driver(sc_module_name name) : sc_module(name) {
     m_enable_delays = true;
     m_resp_pending = 0;
+    m_rand.seed(1, this->name());
   }
 
   //-------------------------------------------------------------
@@ -42,6 +44,7 @@ public:
   // API
   //-------------------------------------------------------------
   void enable_delays(bool enable) { m_enable_delays = enable; }
+  void seed(uint32_t seed) { m_rand.seed(seed, this->name()); }
 
   void write(uint32_t, uint8_t data);
   uint8_t read(uint32_t addr);
@@ -53,7 +56,7 @@ public:
   void write(uint32_t addr, uint8_t *data, int length);
   void read(uint32_t addr, uint8_t *data, int length);
 
-  bool delay_cycle(void) { return m_enable_delays ? rand() & 1 : 0; }
+  bool delay_cycle(void) { return m_enable_delays ? m_rand.bit() : 0; }
 
 protected:
   void write_internal(uint32_t addr, uint8_t *data, int length,
@@ -65,6 +68,7 @@ protected:
   // Members
   //-------------------------------------------------------------
   bool m_enable_delays;
+  tb_rand m_rand;
 
   uint32_t m_resp_pending;
 };
@@ -1,10 +1,14 @@
 #include "tb_axi4_driver.h"
+#include "tb_sim_profile.h"
 #include <queue>
 
 #define BURSTABLE(addr, length, burst_size)                                    \
   (!(addr & (burst_size - 1)) /*一次 burst 的起始地址必须对齐*/ &&             \
    length >= burst_size)
 
+// Bursts of 8, 4, 2 and 1 full beats
+#define BEAT_BYTES AXI4_STRB_W
+
 typedef struct axi_resp_s {
   uint32_t addr;
   uint32_t size;
@@ -20,21 +24,21 @@ void tb_axi4_driver::write_internal(uint32_t addr, uint8_t *data, int length,
   std::queue<axi4_master> req_q;
   std::queue<axi4_master> resp_q;
 
-  sc_assert(initial_mask == 0xF || length == 4);
+  sc_assert(initial_mask == AXI4_STRB_MASK || length == 4);
 
   // Build request queue
   while (length > 0) {
     int chunk = 1;
 
     // 优先级匹配, 一次突发传输尽可能多的数据
-    if (BURSTABLE(addr, length, 32))
-      chunk = 32;
-    else if (BURSTABLE(addr, length, 16))
-      chunk = 16;
-    else if (BURSTABLE(addr, length, 8))
-      chunk = 8;
-    else if (BURSTABLE(addr, length, 4) && length > 4)
-      chunk = 4;
+    if (BURSTABLE(addr, length, 8 * BEAT_BYTES))
+      chunk = 8 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 4 * BEAT_BYTES))
+      chunk = 4 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 2 * BEAT_BYTES))
+      chunk = 2 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, BEAT_BYTES) && length > BEAT_BYTES)
+      chunk = BEAT_BYTES;
     else
       chunk = 1;
 
@@ -42,13 +46,13 @@ void tb_axi4_driver::write_internal(uint32_t addr, uint8_t *data, int length,
       axi4_master req;
       sc_uint<AXI4_ID_W> id = get_rand_id();
 
-      uint32_t addr_offset = addr & 3;
-      int size = (4 - addr_offset);
+      uint32_t addr_offset = addr & (BEAT_BYTES - 1);
+      int size = (BEAT_BYTES - addr_offset);
       if (size > length)
         size = length;
 
-      sc_uint<32> word_data = 0;
-      sc_uint<4> word_mask = 0;
+      sc_uint<AXI4_DATA_W> word_data = 0;
+      sc_uint<AXI4_STRB_W> word_mask = 0;
 
       for (int x = 0; x < size; x++) {
         word_data.range(((addr_offset + x) * 8) + 7, ((addr_offset + x) * 8)) =
@@ -57,7 +61,7 @@ void tb_axi4_driver::write_internal(uint32_t addr, uint8_t *data, int length,
       }
 
       req.AWVALID = true;
-      req.AWADDR = addr & ~3;
+      req.AWADDR = addr & ~(BEAT_BYTES - 1);
       req.AWID = id;
       req.AWLEN = 1 - 1;
       req.WVALID = true;
@@ -74,26 +78,26 @@ void tb_axi4_driver::write_internal(uint32_t addr, uint8_t *data, int length,
     } else {
       sc_uint<AXI4_ID_W> id = get_rand_id();
 
-      for (int i = 0; i < (chunk / 4); i++) {
+      for (int i = 0; i < (chunk / BEAT_BYTES); i++) {
         axi4_master req;
 
-        uint32_t word_data = 0;
-        for (int x = 0; x < 4; x++)
-          word_data |= (((uint32_t)*data++) << (8 * x));
+        uint64_t word_data = 0;
+        for (int x = 0; x < BEAT_BYTES; x++)
+          word_data |= (((uint64_t)*data++) << (8 * x));
 
         if (i == 0) { // 只有第一拍会有 aw 握手, 后续的拍都不会
           req.AWVALID = true;
           req.AWADDR = addr;
           req.AWBURST = AXI4_BURST_INCR;
-          req.AWLEN = (chunk / 4) - 1;
+          req.AWLEN = (chunk / BEAT_BYTES) - 1;
           req.BREADY = true;
         }
 
         req.AWID = id;
         req.WVALID = true;
         req.WDATA = word_data;
-        req.WSTRB = 0xF;
-        req.WLAST = (i == ((chunk / 4) - 1));
+        req.WSTRB = AXI4_STRB_MASK;
+        req.WLAST = (i == ((chunk / BEAT_BYTES) - 1));
 
         // axi4 的 burst, 是: 一次 burst 里面包含多次 w 握手;
         // 而不是一次 w 握手中, 传输多拍数据. 之前理解一直有误
@@ -186,7 +190,7 @@ void tb_axi4_driver::write_internal(uint32_t addr, uint8_t *data, int length,
 // write: Write a block to a target
 //-----------------------------------------------------------------
 void tb_axi4_driver::write(uint32_t addr, uint8_t *data, int length) {
-  write_internal(addr, data, length, 0xF);
+  write_internal(addr, data, length, AXI4_STRB_MASK);
 }
 //-----------------------------------------------------------------
 // read: Read a block to a target
@@ -199,22 +203,20 @@ void tb_axi4_driver::read(uint32_t addr, uint8_t *data, int length) {
   while (length > 0) {
     int chunk = 1;
 
-    if (BURSTABLE(addr, length, 32))
-      chunk = 32;
-    else if (BURSTABLE(addr, length, 16))
-      chunk = 16;
-    else if (BURSTABLE(addr, length, 8))
-      chunk = 8;
-    else if (BURSTABLE(addr, length, 4))
-      chunk = 4;
+    if (BURSTABLE(addr, length, 8 * BEAT_BYTES))
+      chunk = 8 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 4 * BEAT_BYTES))
+      chunk = 4 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 2 * BEAT_BYTES))
+      chunk = 2 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, BEAT_BYTES))
+      chunk = BEAT_BYTES;
     else
       chunk = 1;
 
     if (chunk == 1 || !m_enable_bursts) {
-      uint32_t resp_data = 0;
-
-      uint32_t addr_offset = addr & 3;
-      int size = (4 - addr_offset);
+      uint32_t addr_offset = addr & (BEAT_BYTES - 1);
+      int size = (BEAT_BYTES - addr_offset);
       if (size > length)
         size = length;
 
@@ -222,7 +224,7 @@ void tb_axi4_driver::read(uint32_t addr, uint8_t *data, int length) {
       sc_uint<AXI4_ID_W> id = get_rand_id();
 
       req.ARVALID = true;
-      req.ARADDR = addr & ~3;
+      req.ARADDR = addr & ~(BEAT_BYTES - 1);
       req.ARID = id;
       req.ARLEN = 1 - 1;
 
@@ -244,24 +246,24 @@ void tb_axi4_driver::read(uint32_t addr, uint8_t *data, int length) {
 
       // axi4 read burst: 一次 ar 握手, 多次 r 握手
       req.ARVALID = true;
-      req.ARADDR = addr & ~3;
+      req.ARADDR = addr & ~(BEAT_BYTES - 1);
       req.ARID = id;
       req.ARBURST = AXI4_BURST_INCR;
-      req.ARLEN = (chunk / 4) - 1;
+      req.ARLEN = (chunk / BEAT_BYTES) - 1;
 
       req_q.push(req);
 
-      for (int i = 0; i < (chunk / 4); i++) {
+      for (int i = 0; i < (chunk / BEAT_BYTES); i++) {
         // Expected response details
         axi_resp_t resp;
         resp.addr = addr;
-        resp.size = 4;
+        resp.size = BEAT_BYTES;
         resp.id = id;
-        resp.last = (i + 1) == (chunk / 4);
+        resp.last = (i + 1) == (chunk / BEAT_BYTES);
         resp_q.push(resp);
 
-        addr += 4;
-        length -= 4;
+        addr += BEAT_BYTES;
+        length -= BEAT_BYTES;
       }
     }
   }
@@ -282,8 +284,8 @@ void tb_axi4_driver::read(uint32_t addr, uint8_t *data, int length) {
       sc_assert(axi_i.RRESP == AXI4_RESP_OKAY);
       sc_assert(axi_i.RLAST == resp.last);
 
-      uint32_t addr_offset = resp.addr & 3;
-      uint32_t resp_data = (uint32_t)axi_i.RDATA;
+      uint32_t addr_offset = resp.addr & (BEAT_BYTES - 1);
+      uint64_t resp_data = (uint64_t)axi_i.RDATA;
       for (int x = 0; x < resp.size; x++)
         *data++ = resp_data >> (8 * (addr_offset + x));
 
@@ -369,3 +371,195 @@ uint8_t tb_axi4_driver::read(uint32_t addr) {
   read(addr, &data, 1);
   return data;
 }
+//-----------------------------------------------------------------
+// post: Queue a burst on the non-blocking interface
+//-----------------------------------------------------------------
+void tb_axi4_driver::post(tb_axi4_txn *txn) {
+  txn->beats = 0;
+  txn->post_cycle = m_cycle;
+
+  if (txn->write) {
+    m_aw_q.push_back(txn);
+    m_w_q.push_back(txn);
+  } else
+    m_ar_q.push_back(txn);
+
+  m_txn_count++;
+}
+//-----------------------------------------------------------------
+// build: Split a block access into bursts (same chunking as read)
+//-----------------------------------------------------------------
+void tb_axi4_driver::build(bool write, uint32_t addr, const uint8_t *data,
+                           int length, std::vector<tb_axi4_txn *> &txns) {
+  while (length > 0) {
+    int chunk = 1;
+
+    if (BURSTABLE(addr, length, 8 * BEAT_BYTES))
+      chunk = 8 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 4 * BEAT_BYTES))
+      chunk = 4 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, 2 * BEAT_BYTES))
+      chunk = 2 * BEAT_BYTES;
+    else if (BURSTABLE(addr, length, BEAT_BYTES))
+      chunk = BEAT_BYTES;
+    else
+      chunk = 1;
+
+    if (chunk == 1 || !m_enable_bursts) {
+      uint32_t addr_offset = addr & (BEAT_BYTES - 1);
+      int size = (BEAT_BYTES - addr_offset);
+      if (size > length)
+        size = length;
+
+      tb_axi4_txn *txn =
+          new tb_axi4_txn(write, addr & ~(BEAT_BYTES - 1), get_rand_id(), 0);
+      if (write) {
+        txn->strb[0] = 0;
+        for (int x = 0; x < size; x++) {
+          txn->data[0] |= ((uint64_t)*data++) << (8 * (addr_offset + x));
+          txn->strb[0] |= 1 << (addr_offset + x);
+        }
+      }
+      txns.push_back(txn);
+
+      addr += size;
+      length -= size;
+    } else {
+      tb_axi4_txn *txn = new tb_axi4_txn(write, addr, get_rand_id(),
+                                         (chunk / BEAT_BYTES) - 1);
+      if (write)
+        for (int i = 0; i < (chunk / BEAT_BYTES); i++)
+          for (int x = 0; x < BEAT_BYTES; x++)
+            txn->data[i] |= ((uint64_t)*data++) << (8 * x);
+      txns.push_back(txn);
+
+      addr += chunk;
+      length -= chunk;
+    }
+  }
+}
+//-----------------------------------------------------------------
+// completed: Pop next finished burst (or NULL)
+//-----------------------------------------------------------------
+tb_axi4_txn *tb_axi4_driver::completed(void) {
+  if (m_done_q.empty())
+    return NULL;
+
+  tb_axi4_txn *txn = m_done_q.front();
+  m_done_q.pop_front();
+  return txn;
+}
+//-----------------------------------------------------------------
+// step: Advance posted bursts by one clock cycle
+//-----------------------------------------------------------------
+void tb_axi4_driver::step(void) {
+  tb_prof_scope prof(TB_PROF_TESTBENCH);
+  axi4_master axi_o = axi_out.read();
+  axi4_slave axi_i = axi_in.read();
+
+  // Read response (in order per ID)
+  if (axi_i.RVALID && axi_o.RREADY) {
+    std::deque<tb_axi4_txn *>::iterator it = m_rd_inflight.begin();
+    while (it != m_rd_inflight.end() && (*it)->id != (int)axi_i.RID)
+      it++;
+    sc_assert(it != m_rd_inflight.end());
+
+    tb_axi4_txn *txn = *it;
+    sc_assert(axi_i.RRESP == AXI4_RESP_OKAY);
+    txn->data[txn->beats++] = (uint64_t)axi_i.RDATA;
+    sc_assert(axi_i.RLAST == (txn->beats == txn->len + 1));
+
+    if (axi_i.RLAST) {
+      txn->done_cycle = m_cycle;
+      m_rd_inflight.erase(it);
+      m_done_q.push_back(txn);
+      m_txn_count--;
+
+      sc_assert(m_resp_pending > 0);
+      m_resp_pending -= 1;
+    }
+  }
+
+  // Write response (in order per ID)
+  if (axi_i.BVALID && axi_o.BREADY) {
+    std::deque<tb_axi4_txn *>::iterator it = m_wr_inflight.begin();
+    while (it != m_wr_inflight.end() && (*it)->id != (int)axi_i.BID)
+      it++;
+    sc_assert(it != m_wr_inflight.end());
+    sc_assert(axi_i.BRESP == AXI4_RESP_OKAY);
+
+    tb_axi4_txn *txn = *it;
+    txn->done_cycle = m_cycle;
+    m_wr_inflight.erase(it);
+    m_done_q.push_back(txn);
+    m_txn_count--;
+
+    sc_assert(m_resp_pending > 0);
+    m_resp_pending -= 1;
+  }
+
+  // Read command accepted
+  if (axi_o.ARVALID && axi_i.ARREADY) {
+    tb_axi4_txn *txn = m_ar_q.front();
+    m_ar_q.pop_front();
+    txn->addr_cycle = m_cycle;
+    m_rd_inflight.push_back(txn);
+    m_resp_pending += 1;
+    axi_o.ARVALID = false;
+  }
+
+  // Write command accepted
+  if (axi_o.AWVALID && axi_i.AWREADY) {
+    tb_axi4_txn *txn = m_aw_q.front();
+    m_aw_q.pop_front();
+    txn->addr_cycle = m_cycle;
+    m_wr_inflight.push_back(txn);
+    m_resp_pending += 1;
+    axi_o.AWVALID = false;
+  }
+
+  // Write data accepted (no interleaving, AW order)
+  if (axi_o.WVALID && axi_i.WREADY) {
+    tb_axi4_txn *txn = m_w_q.front();
+    if (++txn->beats == txn->len + 1)
+      m_w_q.pop_front();
+    axi_o.WVALID = false;
+  }
+
+  // Issue next read command
+  if (!axi_o.ARVALID && m_ar_q.size() > 0 && !delay_cycle()) {
+    tb_axi4_txn *txn = m_ar_q.front();
+    axi_o.ARVALID = true;
+    axi_o.ARADDR = txn->addr;
+    axi_o.ARID = txn->id;
+    axi_o.ARLEN = txn->len;
+    axi_o.ARBURST = txn->burst;
+  }
+
+  // Issue next write command
+  if (!axi_o.AWVALID && m_aw_q.size() > 0 && !delay_cycle()) {
+    tb_axi4_txn *txn = m_aw_q.front();
+    axi_o.AWVALID = true;
+    axi_o.AWADDR = txn->addr;
+    axi_o.AWID = txn->id;
+    axi_o.AWLEN = txn->len;
+    axi_o.AWBURST = txn->burst;
+  }
+
+  // Issue next write data beat
+  if (!axi_o.WVALID && m_w_q.size() > 0 && !delay_cycle()) {
+    tb_axi4_txn *txn = m_w_q.front();
+    axi_o.WVALID = true;
+    axi_o.WDATA = txn->data[txn->beats];
+    axi_o.WSTRB = txn->strb[txn->beats];
+    axi_o.WLAST = (txn->beats == txn->len);
+  }
+
+  axi_o.RREADY = !delay_cycle();
+  axi_o.BREADY = !delay_cycle();
+  axi_out.write(axi_o);
+
+  prof.stop();
+  wait();
+  m_cycle++;
+}
@@ -4,6 +4,45 @@
 #include "axi4.h"
 #include "axi4_defines.h"
 #include "tb_driver_api.h"
+#include "tb_rand.h"
+#include <deque>
+#include <vector>
+
+//-------------------------------------------------------------
+// tb_axi4_txn: Burst for the non-blocking (post / step) interface
+//-------------------------------------------------------------
+struct tb_axi4_txn {
+  bool write;
+  uint32_t addr;
+  int id;
+  int len; // AxLEN (beats - 1)
+  int burst;
+  std::vector<uint64_t> data; // Write / read data, AXI4_DATA_W per beat
+  std::vector<uint8_t> strb;  // Write strobes (per beat)
+
+  // Progress (driver owned)
+  int beats;
+  uint64_t post_cycle;
+  uint64_t addr_cycle;
+  uint64_t done_cycle;
+
+  // Owner tag
+  uint64_t user;
+
+  tb_axi4_txn(bool wr, uint32_t a, int axid, int axlen,
+              int axburst = AXI4_BURST_INCR) {
+    write = wr;
+    addr = a;
+    id = axid;
+    len = axlen;
+    burst = axburst;
+    data.resize(len + 1, 0);
+    strb.resize(len + 1, wr ? AXI4_STRB_MASK : 0);
+    beats = 0;
+    post_cycle = addr_cycle = done_cycle = 0;
+    user = 0;
+  }
+};
 
 //-------------------------------------------------------------
 // tb_axi4_driver: AXI4 driver interface
@@ -26,6 +65,9 @@ public:
     m_min_id = 0;
     m_max_id = 15;
     m_resp_pending = 0;
+    m_txn_count = 0;
+    m_cycle = 0;
+    m_rand.seed(1, this->name());
   }
 
   //-------------------------------------------------------------
@@ -47,11 +89,12 @@ public:
   //-------------------------------------------------------------
   void enable_delays(bool enable) { m_enable_delays = enable; }
   void enable_bursts(bool enable) { m_enable_bursts = enable; }
+  void seed(uint32_t seed) { m_rand.seed(seed, this->name()); }
 
   // ID control
   int get_rand_id(void) {
     if ((m_max_id - m_min_id) > 0)
-      return m_min_id + rand() % (m_max_id - m_min_id);
+      return m_min_id + m_rand.below(m_max_id - m_min_id);
     else
       return m_min_id;
   }
@@ -70,7 +113,20 @@ public:
   void write(uint32_t addr, uint8_t *data, int length);
   void read(uint32_t addr, uint8_t *data, int length);
 
-  bool delay_cycle(void) { return m_enable_delays ? rand() & 1 : 0; }
+  bool delay_cycle(void) { return m_enable_delays ? m_rand.bit() : 0; }
+
+  // Non-blocking interface: post() queues a burst, step() advances all
+  // queued bursts by one clock, completed() returns finished bursts in
+  // completion order. Cycle counts only advance while stepping.
+  void post(tb_axi4_txn *txn);
+  void step(void);
+  tb_axi4_txn *completed(void);
+  int outstanding(void) { return m_txn_count; }
+  uint64_t cycle(void) { return m_cycle; }
+
+  // Split a block access into bursts for post() (data = NULL for reads)
+  void build(bool write, uint32_t addr, const uint8_t *data, int length,
+             std::vector<tb_axi4_txn *> &txns);
 
 protected:
   void write_internal(uint32_t addr, uint8_t *data, int length,
@@ -83,8 +139,19 @@ protected:
   bool m_enable_bursts;
   int m_min_id;
   int m_max_id;
+  tb_rand m_rand;
 
   uint32_t m_resp_pending;
+
+  // Non-blocking interface state
+  std::deque<tb_axi4_txn *> m_ar_q;
+  std::deque<tb_axi4_txn *> m_aw_q;
+  std::deque<tb_axi4_txn *> m_w_q;
+  std::deque<tb_axi4_txn *> m_rd_inflight;
+  std::deque<tb_axi4_txn *> m_wr_inflight;
+  std::deque<tb_axi4_txn *> m_done_q;
+  int m_txn_count;
+  uint64_t m_cycle;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "tb_axi4_interconnect.h"
+#include "tb_sim_profile.h"
+#include <string.h>
+
+//-------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------
+tb_axi4_interconnect::tb_axi4_interconnect(sc_module_name name, int masters)
+    : sc_module(name), m_ar_grant("ar_grant", -1),
+      m_aw_grant("aw_grant", -1), m_w_owner("w_owner", -1) {
+  sc_assert(masters > 0 && masters <= TB_AXI4_IC_MAX_MASTERS);
+
+  m_masters = masters;
+  m_master_w = 0;
+  while ((1 << m_master_w) < masters)
+    m_master_w++;
+
+  m_arb = TB_ARB_ROUND_ROBIN;
+  m_qos.resize(masters, 0);
+  m_ar_last = m_aw_last = masters - 1;
+
+  m_ar_waiting.resize(masters, 0);
+  m_aw_waiting.resize(masters, 0);
+  m_ar_starved.resize(masters, 0);
+  m_aw_starved.resize(masters, 0);
+  m_ar_wait.resize(masters);
+  m_aw_wait.resize(masters);
+
+  for (int i = 0; i < TB_AXI4_IC_MAX_MASTERS; i++) {
+    axi_m_in[i] = NULL;
+    axi_s_out[i] = NULL;
+  }
+
+  SC_METHOD(async_outputs);
+  sensitive << axi_s_in;
+  sensitive << m_ar_grant;
+  sensitive << m_aw_grant;
+  sensitive << m_w_owner;
+
+  for (int i = 0; i < masters; i++) {
+    char port_name[32];
+    sprintf(port_name, "axi_m_in%d", i);
+    axi_m_in[i] = new sc_in<axi4_master>(port_name);
+    sprintf(port_name, "axi_s_out%d", i);
+    axi_s_out[i] = new sc_out<axi4_slave>(port_name);
+
+    sensitive << *axi_m_in[i];
+  }
+
+  SC_CTHREAD(process, clk_in.pos());
+}
+//-----------------------------------------------------------------
+// parse_arb: Arbitration scheme from name (-1 if unknown)
+//-----------------------------------------------------------------
+int tb_axi4_interconnect::parse_arb(const char *s) {
+  if (!strcmp(s, "rr") || !strcmp(s, "round_robin"))
+    return TB_ARB_ROUND_ROBIN;
+  else if (!strcmp(s, "fixed"))
+    return TB_ARB_FIXED;
+  else if (!strcmp(s, "qos"))
+    return TB_ARB_QOS;
+  else
+    return -1;
+}
+//-----------------------------------------------------------------
+// arb_name: Arbitration scheme name
+//-----------------------------------------------------------------
+const char *tb_axi4_interconnect::arb_name(int arb) {
+  switch (arb) {
+  case TB_ARB_ROUND_ROBIN:
+    return "round_robin";
+  case TB_ARB_FIXED:
+    return "fixed";
+  case TB_ARB_QOS:
+    return "qos";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// arbitrate: Pick a winner from the request mask (-1 if none)
+//-----------------------------------------------------------------
+int tb_axi4_interconnect::arbitrate(uint32_t req, int &last) {
+  int best = -1;
+
+  for (int k = 1; k <= m_masters && req; k++) {
+    int i = (m_arb == TB_ARB_FIXED) ? (k - 1) : ((last + k) % m_masters);
+    if (!(req & (1 << i)))
+      continue;
+
+    if (best < 0 || (m_arb == TB_ARB_QOS && m_qos[i] > m_qos[best]))
+      best = i;
+
+    if (m_arb != TB_ARB_QOS)
+      break;
+  }
+
+  if (best >= 0)
+    last = best;
+  return best;
+}
+//-----------------------------------------------------------------
+// async_outputs: Route granted requests down, responses up
+//-----------------------------------------------------------------
+void tb_axi4_interconnect::async_outputs(void) {
+  tb_prof_scope prof(TB_PROF_TESTBENCH);
+  axi4_slave s = axi_s_in.read();
+  int ar = m_ar_grant.read();
+  int aw = m_aw_grant.read();
+  int w = m_w_owner.read();
+  int r_dst = (int)s.RID >> id_width();
+  int b_dst = (int)s.BID >> id_width();
+  uint32_t id_mask = (1 << id_width()) - 1;
+
+  axi4_master out;
+
+  if (ar >= 0) {
+    axi4_master m = axi_m_in[ar]->read();
+    out.ARVALID = m.ARVALID;
+    out.ARADDR = m.ARADDR;
+    out.ARID = (ar << id_width()) | (m.ARID & id_mask);
+    out.ARLEN = m.ARLEN;
+    out.ARBURST = m.ARBURST;
+  }
+
+  if (aw >= 0) {
+    axi4_master m = axi_m_in[aw]->read();
+    out.AWVALID = m.AWVALID;
+    out.AWADDR = m.AWADDR;
+    out.AWID = (aw << id_width()) | (m.AWID & id_mask);
+    out.AWLEN = m.AWLEN;
+    out.AWBURST = m.AWBURST;
+  }
+
+  if (w >= 0) {
+    axi4_master m = axi_m_in[w]->read();
+    out.WVALID = m.WVALID;
+    out.WDATA = m.WDATA;
+    out.WSTRB = m.WSTRB;
+    out.WLAST = m.WLAST;
+  }
+
+  if (s.RVALID && r_dst < m_masters)
+    out.RREADY = axi_m_in[r_dst]->read().RREADY;
+  if (s.BVALID && b_dst < m_masters)
+    out.BREADY = axi_m_in[b_dst]->read().BREADY;
+
+  axi_m_out.write(out);
+
+  for (int i = 0; i < m_masters; i++) {
+    axi4_slave o;
+
+    o.ARREADY = (ar == i) && s.ARREADY;
+    o.AWREADY = (aw == i) && s.AWREADY;
+    o.WREADY = (w == i) && s.WREADY;
+
+    if (s.RVALID && r_dst == i) {
+      o.RVALID = true;
+      o.RDATA = s.RDATA;
+      o.RRESP = s.RRESP;
+      o.RID = s.RID & id_mask;
+      o.RLAST = s.RLAST;
+    }
+
+    if (s.BVALID && b_dst == i) {
+      o.BVALID = true;
+      o.BRESP = s.BRESP;
+      o.BID = s.BID & id_mask;
+    }
+
+    axi_s_out[i]->write(o);
+  }
+}
+//-----------------------------------------------------------------
+// process: Arbitration (registered grants)
+//-----------------------------------------------------------------
+void tb_axi4_interconnect::process(void) {
+  while (true) {
+    wait();
+    tb_prof_scope prof(TB_PROF_TESTBENCH);
+
+    if (rst_in.read()) {
+      m_w_route.clear();
+      m_ar_grant.write(-1);
+      m_aw_grant.write(-1);
+      m_w_owner.write(-1);
+      continue;
+    }
+
+    axi4_slave s = axi_s_in.read();
+    axi4_master m[TB_AXI4_IC_MAX_MASTERS];
+    uint32_t ar_req = 0;
+    uint32_t aw_req = 0;
+
+    for (int i = 0; i < m_masters; i++) {
+      m[i] = axi_m_in[i]->read();
+      if (m[i].ARVALID)
+        ar_req |= 1 << i;
+      if (m[i].AWVALID)
+        aw_req |= 1 << i;
+    }
+
+    int ar = m_ar_grant.read();
+    int aw = m_aw_grant.read();
+    bool ar_fire = (ar >= 0) && m[ar].ARVALID && s.ARREADY;
+    bool aw_fire = (aw >= 0) && m[aw].AWVALID && s.AWREADY;
+
+    // Wait / starvation accounting
+    for (int i = 0; i < m_masters; i++) {
+      if (ar_req & (1 << i)) {
+        if (ar_fire && ar == i) {
+          m_ar_wait[i].add(m_ar_waiting[i]);
+          m_ar_waiting[i] = 0;
+        } else {
+          m_ar_waiting[i]++;
+          if (ar >= 0 && ar != i)
+            m_ar_starved[i]++;
+        }
+      }
+
+      if (aw_req & (1 << i)) {
+        if (aw_fire && aw == i) {
+          m_aw_wait[i].add(m_aw_waiting[i]);
+          m_aw_waiting[i] = 0;
+        } else {
+          m_aw_waiting[i]++;
+          if (aw >= 0 && aw != i)
+            m_aw_starved[i]++;
+        }
+      }
+    }
+
+    // W: retire the owner at the end of its burst
+    int w = m_w_route.empty() ? -1 : m_w_route.front();
+    if (w >= 0 && m[w].WVALID && s.WREADY && m[w].WLAST)
+      m_w_route.pop_front();
+
+    // AR: a presented request must be held until accepted
+    if (ar < 0 || ar_fire)
+      ar = arbitrate(ar_fire ? (ar_req & ~(1 << ar)) : ar_req, m_ar_last);
+    else
+      sc_assert(m[ar].ARVALID);
+
+    // AW: new grants also claim the W channel (in order)
+    if (aw < 0 || aw_fire) {
+      aw = arbitrate(aw_fire ? (aw_req & ~(1 << aw)) : aw_req, m_aw_last);
+      if (aw >= 0)
+        m_w_route.push_back(aw);
+    } else
+      sc_assert(m[aw].AWVALID);
+
+    m_ar_grant.write(ar);
+    m_aw_grant.write(aw);
+    m_w_owner.write(m_w_route.empty() ? -1 : m_w_route.front());
+  }
+}
+//-----------------------------------------------------------------
+// print_stats: Per master arbitration summary
+//-----------------------------------------------------------------
+void tb_axi4_interconnect::print_stats(void) {
+  printf("INTERCONNECT: %d masters, %s arbitration\n", m_masters,
+         arb_name(m_arb));
+
+  for (int i = 0; i < m_masters; i++) {
+    printf("INTERCONNECT: master %d: AR wait mean %.2f max %llu, "
+           "AW wait mean %.2f max %llu, starved %llu / %llu cycles\n",
+           i, m_ar_wait[i].mean(), (unsigned long long)m_ar_wait[i].max(),
+           m_aw_wait[i].mean(), (unsigned long long)m_aw_wait[i].max(),
+           (unsigned long long)m_ar_starved[i],
+           (unsigned long long)m_aw_starved[i]);
+  }
+}
+//-----------------------------------------------------------------
+// write_json: Arbitration results for one master
+//-----------------------------------------------------------------
+void tb_axi4_interconnect::write_json(tb_json &js, int master) {
+  js.value("qos", m_qos[master]);
+  js.begin_object("read");
+  js.value("starved_cycles", m_ar_starved[master]);
+  m_ar_wait[master].write_json(js, "grant_wait");
+  js.end_object();
+  js.begin_object("write");
+  js.value("starved_cycles", m_aw_starved[master]);
+  m_aw_wait[master].write_json(js, "grant_wait");
+  js.end_object();
+}
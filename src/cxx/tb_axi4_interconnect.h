@@ -0,0 +1,102 @@
+#ifndef TB_AXI4_INTERCONNECT_H
+#define TB_AXI4_INTERCONNECT_H
+
+#include "axi4.h"
+#include "axi4_defines.h"
+#include "tb_histogram.h"
+#include "tb_json.h"
+#include <deque>
+#include <vector>
+
+#define TB_AXI4_IC_MAX_MASTERS (1 << AXI4_ID_W)
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_ARB { TB_ARB_ROUND_ROBIN, TB_ARB_FIXED, TB_ARB_QOS };
+
+//-------------------------------------------------------------
+// tb_axi4_interconnect: N:1 AXI4 interconnect model
+//   AR and AW are arbitrated independently on each clock. A
+//   grant is held until the presented request is accepted; W
+//   beats follow AW grant order (no interleaving). The master
+//   index is carried in the upper ID bits towards the slave and
+//   stripped again to route R / B, so each master has id_width()
+//   ID bits of its own.
+//   Arbitration:
+//     TB_ARB_ROUND_ROBIN - rotate from the last winner
+//     TB_ARB_FIXED       - lowest master index wins
+//     TB_ARB_QOS         - highest set_qos() value wins, ties
+//                          resolved round robin (axi4_master has
+//                          no AxQOS, so QoS is per port)
+//-------------------------------------------------------------
+class tb_axi4_interconnect : public sc_module {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  // Upstream (one per master)
+  sc_in<axi4_master> *axi_m_in[TB_AXI4_IC_MAX_MASTERS];
+  sc_out<axi4_slave> *axi_s_out[TB_AXI4_IC_MAX_MASTERS];
+
+  // Downstream (slave)
+  sc_out<axi4_master> axi_m_out;
+  sc_in<axi4_slave> axi_s_in;
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_axi4_interconnect);
+  tb_axi4_interconnect(sc_module_name name, int masters);
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  void set_arbitration(int arb) { m_arb = arb; }
+  void set_qos(int master, int qos) { m_qos[master] = qos; }
+
+  int masters(void) { return m_masters; }
+  int id_width(void) { return AXI4_ID_W - m_master_w; }
+
+  static int parse_arb(const char *s);
+  static const char *arb_name(int arb);
+
+  void print_stats(void);
+  void write_json(tb_json &js, int master);
+
+protected:
+  int arbitrate(uint32_t req, int &last);
+  void async_outputs(void);
+  void process(void);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  int m_masters;
+  int m_master_w;
+  int m_arb;
+  std::vector<int> m_qos;
+
+  sc_signal<int> m_ar_grant;
+  sc_signal<int> m_aw_grant;
+  sc_signal<int> m_w_owner;
+  int m_ar_last;
+  int m_aw_last;
+
+  // AW grant order, for routing W beats
+  std::deque<int> m_w_route;
+
+  // Stats: cycles from valid to accept, and cycles spent waiting
+  // while another master held the grant (starvation)
+  std::vector<uint64_t> m_ar_waiting;
+  std::vector<uint64_t> m_aw_waiting;
+  std::vector<uint64_t> m_ar_starved;
+  std::vector<uint64_t> m_aw_starved;
+  std::vector<tb_histogram> m_ar_wait;
+  std::vector<tb_histogram> m_aw_wait;
+};
+
+#endif
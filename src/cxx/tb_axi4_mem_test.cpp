@@ -0,0 +1,93 @@
+#include "tb_axi4_mem_test.h"
+
+//-----------------------------------------------------------------
+// next_access: Next access from the pattern or the random mix
+//-----------------------------------------------------------------
+void tb_axi4_mem_test::next_access(tb_access &acc) {
+  if (m_pattern) {
+    m_pattern->next(acc);
+    return;
+  }
+
+  switch (m_rand.below(4)) {
+  // Word write / read
+  case 0:
+  case 1:
+    acc.write = m_rand.bit();
+    acc.length = 4;
+    acc.addr = get_mem_address(4, 4);
+    break;
+  // Block write / read
+  default:
+    acc.write = m_rand.bit();
+    acc.length = 1 + m_rand.below(m_max_length);
+    acc.addr = get_mem_address(acc.length, 1);
+    break;
+  }
+}
+//-----------------------------------------------------------------
+// tick: Advance the driver one clock, retire completed bursts
+//-----------------------------------------------------------------
+void tb_axi4_mem_test::tick(void) {
+  m_axi->step();
+
+  tb_axi4_txn *txn;
+  while ((txn = m_axi->completed()) != NULL) {
+    m_scoreboard.completed(txn);
+    delete txn;
+  }
+}
+//-----------------------------------------------------------------
+// issue: Post a burst once it is hazard free and there is room
+//-----------------------------------------------------------------
+void tb_axi4_mem_test::issue(tb_axi4_txn *txn) {
+  while (m_scoreboard.outstanding() >= m_max_outstanding ||
+         m_scoreboard.hazard(txn))
+    tick();
+
+  m_scoreboard.posted(txn);
+  m_axi->post(txn);
+}
+//-----------------------------------------------------------------
+// process: Random reads and writes (non-blocking)
+//-----------------------------------------------------------------
+void tb_axi4_mem_test::process(void) {
+  while (true) {
+    m_enabled.wait();
+    if (m_pattern)
+      printf("Starting memory test sequence (%s)...\n", m_pattern->name());
+    else
+      printf("Starting memory test sequence...\n");
+
+    int iterations = m_iterations.read();
+
+    while (!m_stop && ((iterations == -1) || (iterations-- >= 1))) {
+      tb_access acc;
+      next_access(acc);
+
+      uint8_t *buffer = NULL;
+      if (acc.write) {
+        buffer = new uint8_t[acc.length];
+        for (int i = 0; i < acc.length; i++)
+          buffer[i] = m_rand.byte();
+      }
+
+      std::vector<tb_axi4_txn *> txns;
+      m_axi->build(acc.write, acc.addr, buffer, acc.length, txns);
+      delete[] buffer; buffer = NULL;
+
+      for (size_t i = 0; i < txns.size(); i++)
+        issue(txns[i]);
+    }
+
+    // Drain
+    while (m_scoreboard.outstanding() > 0)
+      tick();
+
+    m_scoreboard.print_stats();
+
+    // Notify completion
+    printf("Completed memory test sequence...\n");
+    m_completed.post();
+  }
+}
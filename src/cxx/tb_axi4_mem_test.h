@@ -0,0 +1,42 @@
+#ifndef TB_AXI4_MEM_TEST_H
+#define TB_AXI4_MEM_TEST_H
+
+#include "tb_axi4_driver.h"
+#include "tb_axi4_scoreboard.h"
+#include "tb_mem_test.h"
+
+//-------------------------------------------------------------
+// tb_axi4_mem_test: Non-blocking memory tester (sequencer)
+//   Same traffic as tb_mem_test (random mix or --testcase
+//   pattern) but every access is posted to the AXI driver
+//   without waiting, with up to max_outstanding bursts in
+//   flight. Checking is done by the scoreboard as responses
+//   arrive, so there are no readbacks in the stream.
+//-------------------------------------------------------------
+class tb_axi4_mem_test : public tb_mem_test {
+public:
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  tb_axi4_mem_test(sc_module_name name, tb_axi4_driver *iface, int max_length)
+      : tb_mem_test(name, iface, max_length), m_scoreboard(this) {
+    m_axi = iface;
+    m_max_outstanding = 8;
+  }
+
+  void set_max_outstanding(int max) { m_max_outstanding = max; }
+
+  // Internal
+protected:
+  void next_access(tb_access &acc);
+  void issue(tb_axi4_txn *txn);
+  void tick(void);
+  void process(void);
+
+protected:
+  tb_axi4_driver *m_axi;
+  tb_axi4_scoreboard m_scoreboard;
+  int m_max_outstanding;
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "tb_axi4_monitor.h"
+#include "tb_chrome_trace.h"
+#include "tb_sim_profile.h"
+
+//-----------------------------------------------------------------
+// reset_stats: Clear counters (outstanding bursts are kept)
+//-----------------------------------------------------------------
+void tb_axi4_monitor::reset_stats(void) {
+  m_start_cycle = m_cycle;
+  m_stop_cycle = m_cycle;
+  m_rd_bytes = 0;
+  m_wr_bytes = 0;
+  m_rd_latency.reset();
+  m_wr_latency.reset();
+  m_rd_gap.reset();
+  m_rd_outstanding_hist.reset();
+  m_wr_outstanding_hist.reset();
+
+  for (int c = 0; c < TB_AXI4_CHAN_MAX; c++) {
+    m_chan[c].xfer = 0;
+    m_chan[c].stall = 0;
+    m_chan[c].idle = 0;
+  }
+
+  for (size_t i = 0; i < m_queues.size(); i++) {
+    m_queues[i].occupancy.reset();
+    m_queues[i].full_cycles = 0;
+  }
+}
+//-----------------------------------------------------------------
+// add_queue: Register a queue occupancy signal
+//-----------------------------------------------------------------
+void tb_axi4_monitor::add_queue(const char *name,
+                                const sc_signal<sc_uint<8>> *level,
+                                int depth) {
+  queue_probe q;
+  q.name = name;
+  q.level = level;
+  q.depth = depth;
+  q.occupancy = tb_histogram(depth + 1);
+  q.full_cycles = 0;
+  m_queues.push_back(q);
+}
+//-----------------------------------------------------------------
+// channel_name: Printable channel
+//-----------------------------------------------------------------
+const char *tb_axi4_monitor::channel_name(int chan) {
+  switch (chan) {
+  case TB_AXI4_CHAN_AW:
+    return "aw";
+  case TB_AXI4_CHAN_W:
+    return "w";
+  case TB_AXI4_CHAN_B:
+    return "b";
+  case TB_AXI4_CHAN_AR:
+    return "ar";
+  case TB_AXI4_CHAN_R:
+    return "r";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// sample_channel: Classify one channel's handshake state
+//-----------------------------------------------------------------
+void tb_axi4_monitor::sample_channel(int chan, bool valid, bool ready) {
+  if (valid && ready)
+    m_chan[chan].xfer++;
+  else if (valid)
+    m_chan[chan].stall++;
+  else if (ready)
+    m_chan[chan].idle++;
+}
+//-----------------------------------------------------------------
+// process: Sample handshakes every clock
+//-----------------------------------------------------------------
+void tb_axi4_monitor::process(void) {
+  while (true) {
+    wait();
+    m_cycle++;
+    tb_prof_scope prof(TB_PROF_TESTBENCH);
+
+    if (rst_in.read())
+      continue;
+
+    axi4_master m = axi_m_in.read();
+    axi4_slave s = axi_s_in.read();
+
+    if (m_enabled) {
+      sample_channel(TB_AXI4_CHAN_AW, m.AWVALID, s.AWREADY);
+      sample_channel(TB_AXI4_CHAN_W, m.WVALID, s.WREADY);
+      sample_channel(TB_AXI4_CHAN_B, s.BVALID, m.BREADY);
+      sample_channel(TB_AXI4_CHAN_AR, m.ARVALID, s.ARREADY);
+      sample_channel(TB_AXI4_CHAN_R, s.RVALID, m.RREADY);
+
+      // Occupancy at the start of this cycle
+      m_rd_outstanding_hist.add(m_rd_outstanding);
+      m_wr_outstanding_hist.add(m_wr_outstanding);
+
+      for (size_t i = 0; i < m_queues.size(); i++) {
+        int level = (int)m_queues[i].level->read();
+        m_queues[i].occupancy.add(level);
+        if (level >= m_queues[i].depth)
+          m_queues[i].full_cycles++;
+      }
+    }
+
+    // Read address
+    if (m.ARVALID && s.ARREADY) {
+      tb_axi4_burst_info info = {m_cycle, (uint32_t)m.ARADDR, (int)m.ARLEN};
+      m_rd_pending[m.ARID].push_back(info);
+      m_rd_outstanding++;
+    }
+
+    // Read data
+    if (s.RVALID && m.RREADY) {
+      if (m_enabled)
+        m_rd_bytes += AXI4_DATA_W / 8;
+
+      // First beat of a burst queued behind the previous one
+      if (!m_rd_started[s.RID]) {
+        std::deque<tb_axi4_burst_info> &q = m_rd_pending[s.RID];
+        sc_assert(q.size() > 0);
+        if (m_enabled && m_last_rlast > m_start_cycle &&
+            q.front().cycle < m_last_rlast)
+          m_rd_gap.add(m_cycle - m_last_rlast - 1);
+        m_rd_started[s.RID] = true;
+      }
+
+      if (s.RLAST) {
+        m_rd_started[s.RID] = false;
+        m_last_rlast = m_cycle;
+
+        std::deque<tb_axi4_burst_info> &q = m_rd_pending[s.RID];
+        sc_assert(q.size() > 0);
+        const tb_axi4_burst_info &info = q.front();
+        if (m_enabled && info.cycle >= m_start_cycle)
+          m_rd_latency.add(m_cycle - info.cycle);
+        if (m_trace)
+          m_trace->axi_burst(false, s.RID, info.addr, info.len, info.cycle,
+                             m_cycle);
+        q.pop_front();
+        m_rd_outstanding--;
+      }
+    }
+
+    // Write address
+    if (m.AWVALID && s.AWREADY) {
+      tb_axi4_burst_info info = {m_cycle, (uint32_t)m.AWADDR, (int)m.AWLEN};
+      m_wr_pending[m.AWID].push_back(info);
+      m_wr_outstanding++;
+    }
+
+    // Write data
+    if (m.WVALID && s.WREADY && m_enabled) {
+      for (int i = 0; i < AXI4_DATA_W / 8; i++)
+        if (m.WSTRB[i])
+          m_wr_bytes++;
+    }
+
+    // Write response
+    if (s.BVALID && m.BREADY) {
+      std::deque<tb_axi4_burst_info> &q = m_wr_pending[s.BID];
+      sc_assert(q.size() > 0);
+      const tb_axi4_burst_info &info = q.front();
+      if (m_enabled && info.cycle >= m_start_cycle)
+        m_wr_latency.add(m_cycle - info.cycle);
+      if (m_trace)
+        m_trace->axi_burst(true, s.BID, info.addr, info.len, info.cycle,
+                           m_cycle);
+      q.pop_front();
+      m_wr_outstanding--;
+    }
+  }
+}
+//-----------------------------------------------------------------
+// print_stats: Summary to stdout
+//-----------------------------------------------------------------
+void tb_axi4_monitor::print_stats(void) {
+  uint64_t cycles = window_cycles();
+
+  printf("AXI: %llu cycles\n", (unsigned long long)cycles);
+  printf("AXI: read  %llu bytes, %.3f bytes/cycle\n",
+         (unsigned long long)m_rd_bytes, read_bw());
+  printf("AXI: write %llu bytes, %.3f bytes/cycle\n",
+         (unsigned long long)m_wr_bytes, write_bw());
+  m_rd_latency.print("AXI: read latency ");
+  m_wr_latency.print("AXI: write latency");
+  m_rd_gap.print("AXI: read gap     ");
+
+  for (int c = 0; c < TB_AXI4_CHAN_MAX; c++) {
+    const tb_axi4_chan_stats &st = m_chan[c];
+    printf("AXI: %-2s xfer %llu (%.1f%%) stall %llu (%.1f%%) idle %llu "
+           "(%.1f%%)\n",
+           channel_name(c), (unsigned long long)st.xfer,
+           cycles ? (100.0 * st.xfer) / cycles : 0.0,
+           (unsigned long long)st.stall,
+           cycles ? (100.0 * st.stall) / cycles : 0.0,
+           (unsigned long long)st.idle,
+           cycles ? (100.0 * st.idle) / cycles : 0.0);
+  }
+
+  m_rd_outstanding_hist.print("AXI: read outstanding ");
+  m_wr_outstanding_hist.print("AXI: write outstanding");
+
+  for (size_t i = 0; i < m_queues.size(); i++) {
+    const queue_probe &q = m_queues[i];
+    std::string name = "AXI: queue " + q.name;
+    q.occupancy.print(name.c_str());
+    printf("AXI: queue %s: full (%d) %llu cycles (%.1f%%)\n", q.name.c_str(),
+           q.depth, (unsigned long long)q.full_cycles,
+           cycles ? (100.0 * q.full_cycles) / cycles : 0.0);
+  }
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_axi4_monitor::write_json(tb_json &js) {
+  js.value("cycles", window_cycles());
+
+  js.begin_object("read");
+  js.value("transactions", read_txns());
+  js.value("bytes", m_rd_bytes);
+  js.value("bytes_per_cycle", read_bw());
+  m_rd_latency.write_json(js, "latency");
+  m_rd_gap.write_json(js, "burst_gap");
+  js.end_object();
+
+  js.begin_object("write");
+  js.value("transactions", write_txns());
+  js.value("bytes", m_wr_bytes);
+  js.value("bytes_per_cycle", write_bw());
+  m_wr_latency.write_json(js, "latency");
+  js.end_object();
+
+  js.value("total_bytes_per_cycle", bytes_per_cycle(m_rd_bytes + m_wr_bytes));
+
+  js.begin_object("channels");
+  for (int c = 0; c < TB_AXI4_CHAN_MAX; c++) {
+    js.begin_object(channel_name(c));
+    js.value("xfer", m_chan[c].xfer);
+    js.value("stall", m_chan[c].stall);
+    js.value("idle", m_chan[c].idle);
+    js.end_object();
+  }
+  js.end_object();
+
+  m_rd_outstanding_hist.write_json(js, "read_outstanding");
+  m_wr_outstanding_hist.write_json(js, "write_outstanding");
+
+  if (!m_queues.empty()) {
+    js.begin_object("queues");
+    for (size_t i = 0; i < m_queues.size(); i++) {
+      js.begin_object(m_queues[i].name.c_str());
+      js.value("depth", m_queues[i].depth);
+      js.value("full_cycles", m_queues[i].full_cycles);
+      m_queues[i].occupancy.write_json(js, "occupancy");
+      js.end_object();
+    }
+    js.end_object();
+  }
+}
@@ -0,0 +1,191 @@
+#ifndef TB_AXI4_MONITOR_H
+#define TB_AXI4_MONITOR_H
+
+#include "axi4.h"
+#include "axi4_defines.h"
+#include "tb_histogram.h"
+#include "tb_json.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+#define TB_AXI4_MAX_IDS (1 << AXI4_ID_W)
+#define TB_AXI4_MAX_OUTSTANDING 64
+
+class tb_chrome_trace;
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_AXI4_CHANNEL {
+  TB_AXI4_CHAN_AW,
+  TB_AXI4_CHAN_W,
+  TB_AXI4_CHAN_B,
+  TB_AXI4_CHAN_AR,
+  TB_AXI4_CHAN_R,
+  TB_AXI4_CHAN_MAX
+};
+
+//-------------------------------------------------------------
+// tb_axi4_chan_stats: Handshake state counts for one channel
+//   xfer:  VALID && READY
+//   stall: VALID && !READY (receiver back-pressure)
+//   idle:  READY && !VALID (sender has nothing to send)
+//-------------------------------------------------------------
+struct tb_axi4_chan_stats {
+  uint64_t xfer;
+  uint64_t stall;
+  uint64_t idle;
+};
+
+//-------------------------------------------------------------
+// tb_axi4_burst_info: Burst awaiting its last response
+//-------------------------------------------------------------
+struct tb_axi4_burst_info {
+  uint64_t cycle; // Address handshake
+  uint32_t addr;
+  int len;
+};
+
+//-------------------------------------------------------------
+// tb_axi4_monitor: Passive AXI4 bandwidth / latency monitor
+//   Latency is measured from the AR (AW) handshake to the last
+//   R (B) handshake of the burst, in clock cycles. Also counts
+//   per channel handshake / stall / idle cycles, samples the
+//   number of outstanding bursts each cycle, and optionally the
+//   occupancy of DUT internal queues (see add_queue). The read
+//   gap is the number of idle R cycles between the last beat of
+//   one burst and the first of the next, when the next burst's
+//   address was already accepted (back-to-back reads).
+//-------------------------------------------------------------
+class tb_axi4_monitor : public sc_module {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  sc_in<axi4_master> axi_m_in;
+  sc_in<axi4_slave> axi_s_in;
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_axi4_monitor);
+  tb_axi4_monitor(sc_module_name name)
+      : sc_module(name), m_rd_outstanding_hist(TB_AXI4_MAX_OUTSTANDING),
+        m_wr_outstanding_hist(TB_AXI4_MAX_OUTSTANDING) {
+    SC_CTHREAD(process, clk_in.pos());
+    m_cycle = 0;
+    m_enabled = false;
+    m_rd_outstanding = 0;
+    m_wr_outstanding = 0;
+    m_last_rlast = 0;
+    for (int i = 0; i < TB_AXI4_MAX_IDS; i++)
+      m_rd_started[i] = false;
+    m_trace = NULL;
+    reset_stats();
+  }
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  // Measurement window
+  void start(void) {
+    reset_stats();
+    m_start_cycle = m_cycle;
+    m_enabled = true;
+  }
+  void stop(void) {
+    m_stop_cycle = m_cycle;
+    m_enabled = false;
+  }
+
+  // Sample a queue occupancy signal every clock (0..depth)
+  void add_queue(const char *name, const sc_signal<sc_uint<8>> *level,
+                 int depth);
+
+  // Emit every completed burst as a trace slice
+  void set_trace(tb_chrome_trace *trace) { m_trace = trace; }
+
+  uint64_t cycle(void) { return m_cycle; }
+  uint64_t window_cycles(void) {
+    return (m_enabled ? m_cycle : m_stop_cycle) - m_start_cycle;
+  }
+
+  uint64_t read_bytes(void) { return m_rd_bytes; }
+  uint64_t write_bytes(void) { return m_wr_bytes; }
+  uint64_t read_txns(void) { return m_rd_latency.count(); }
+  uint64_t write_txns(void) { return m_wr_latency.count(); }
+  double read_bw(void) { return bytes_per_cycle(m_rd_bytes); }
+  double write_bw(void) { return bytes_per_cycle(m_wr_bytes); }
+
+  const tb_histogram &read_latency(void) { return m_rd_latency; }
+  const tb_histogram &write_latency(void) { return m_wr_latency; }
+  const tb_histogram &read_gap(void) { return m_rd_gap; }
+  const tb_histogram &read_outstanding(void) { return m_rd_outstanding_hist; }
+  const tb_histogram &write_outstanding(void) {
+    return m_wr_outstanding_hist;
+  }
+  const tb_axi4_chan_stats &channel(int chan) { return m_chan[chan]; }
+
+  static const char *channel_name(int chan);
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+protected:
+  void process(void);
+  void reset_stats(void);
+  void sample_channel(int chan, bool valid, bool ready);
+  double bytes_per_cycle(uint64_t bytes) {
+    uint64_t cycles = window_cycles();
+    return cycles ? (double)bytes / cycles : 0.0;
+  }
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  uint64_t m_cycle;
+  bool m_enabled;
+  uint64_t m_start_cycle;
+  uint64_t m_stop_cycle;
+
+  tb_chrome_trace *m_trace;
+
+  // Outstanding bursts, per ID
+  std::deque<tb_axi4_burst_info> m_rd_pending[TB_AXI4_MAX_IDS];
+  std::deque<tb_axi4_burst_info> m_wr_pending[TB_AXI4_MAX_IDS];
+
+  uint64_t m_rd_bytes;
+  uint64_t m_wr_bytes;
+  tb_histogram m_rd_latency;
+  tb_histogram m_wr_latency;
+
+  // Back-to-back read bursts: idle R cycles between them
+  bool m_rd_started[TB_AXI4_MAX_IDS];
+  uint64_t m_last_rlast;
+  tb_histogram m_rd_gap;
+
+  // Channel handshake states
+  tb_axi4_chan_stats m_chan[TB_AXI4_CHAN_MAX];
+
+  // Outstanding bursts (address accepted, last response not yet seen)
+  int m_rd_outstanding;
+  int m_wr_outstanding;
+  tb_histogram m_rd_outstanding_hist;
+  tb_histogram m_wr_outstanding_hist;
+
+  // DUT queue occupancy
+  struct queue_probe {
+    std::string name;
+    const sc_signal<sc_uint<8>> *level;
+    int depth;
+    tb_histogram occupancy;
+    uint64_t full_cycles;
+  };
+  std::vector<queue_probe> m_queues;
+};
+
+#endif
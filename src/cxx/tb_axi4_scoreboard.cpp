@@ -0,0 +1,123 @@
+#include "tb_axi4_scoreboard.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// beat_addr: Aligned address of a beat within a burst
+//-----------------------------------------------------------------
+uint32_t tb_axi4_scoreboard::beat_addr(const tb_axi4_txn *txn, int beat) {
+  uint32_t addr = txn->addr & ~(AXI4_STRB_W - 1);
+  uint32_t bytes = (txn->len + 1) * AXI4_STRB_W;
+
+  switch (txn->burst) {
+  case AXI4_BURST_FIXED:
+    return addr;
+  case AXI4_BURST_WRAP: {
+    uint32_t lo = addr & ~(bytes - 1);
+    return lo + ((addr - lo + (beat * AXI4_STRB_W)) % bytes);
+  }
+  default:
+    return addr + (beat * AXI4_STRB_W);
+  }
+}
+//-----------------------------------------------------------------
+// span: Byte range [lo, hi) touched by a burst
+//-----------------------------------------------------------------
+void tb_axi4_scoreboard::span(const tb_axi4_txn *txn, uint32_t &lo,
+                              uint32_t &hi) {
+  uint32_t bytes = (txn->len + 1) * AXI4_STRB_W;
+
+  switch (txn->burst) {
+  case AXI4_BURST_FIXED:
+    lo = txn->addr & ~(AXI4_STRB_W - 1);
+    hi = lo + AXI4_STRB_W;
+    break;
+  case AXI4_BURST_WRAP:
+    lo = txn->addr & ~(bytes - 1);
+    hi = lo + bytes;
+    break;
+  default:
+    lo = txn->addr & ~(AXI4_STRB_W - 1);
+    hi = lo + bytes;
+    break;
+  }
+}
+//-----------------------------------------------------------------
+// overlap: Do two bursts touch any common byte?
+//-----------------------------------------------------------------
+bool tb_axi4_scoreboard::overlap(const tb_axi4_txn *a, const tb_axi4_txn *b) {
+  uint32_t a_lo, a_hi, b_lo, b_hi;
+  span(a, a_lo, a_hi);
+  span(b, b_lo, b_hi);
+  return (a_lo < b_hi) && (b_lo < a_hi);
+}
+//-----------------------------------------------------------------
+// hazard: Would posting this burst make the expected data ambiguous?
+//-----------------------------------------------------------------
+bool tb_axi4_scoreboard::hazard(const tb_axi4_txn *txn) {
+  for (size_t i = 0; i < m_pending.size(); i++) {
+    tb_axi4_txn *p = m_pending[i];
+    if ((p->write || txn->write) && overlap(p, txn))
+      return true;
+  }
+  return false;
+}
+//-----------------------------------------------------------------
+// posted: Track a burst handed to the driver
+//-----------------------------------------------------------------
+void tb_axi4_scoreboard::posted(tb_axi4_txn *txn) {
+  sc_assert(txn->id < TB_SB_MAX_IDS);
+  m_pending.push_back(txn);
+  m_order[txn->write][txn->id].push_back(txn);
+}
+//-----------------------------------------------------------------
+// completed: Check ordering, then update (write) or check (read)
+//-----------------------------------------------------------------
+void tb_axi4_scoreboard::completed(tb_axi4_txn *txn) {
+  std::deque<tb_axi4_txn *> &order = m_order[txn->write][txn->id];
+  if (order.empty() || order.front() != txn)
+    printf("ORDER: %s ID %d @ %08x completed ahead of an older burst\n",
+           txn->write ? "Write" : "Read", txn->id, txn->addr);
+  sc_assert(!order.empty() && order.front() == txn);
+  order.pop_front();
+
+  std::deque<tb_axi4_txn *>::iterator it =
+      std::find(m_pending.begin(), m_pending.end(), txn);
+  sc_assert(it != m_pending.end());
+  m_pending.erase(it);
+
+  for (int i = 0; i <= txn->len; i++) {
+    uint32_t addr = beat_addr(txn, i);
+
+    for (int x = 0; x < AXI4_STRB_W; x++) {
+      uint8_t data = txn->data[i] >> (8 * x);
+
+      if (txn->write) {
+        if (txn->strb[i] & (1 << x))
+          m_model->write(addr + x, data);
+      } else {
+        uint8_t expected = m_model->read(addr + x);
+        if (data != expected) {
+          printf("MISMATCH: %08x -> %02x != %02x (ID %d)\n", addr + x, data,
+                 expected, txn->id);
+          m_errors++;
+        }
+        m_bytes_checked++;
+        sc_assert(data == expected);
+      }
+    }
+  }
+
+  if (txn->write)
+    m_writes++;
+  else
+    m_reads++;
+}
+//-----------------------------------------------------------------
+// print_stats: Summary
+//-----------------------------------------------------------------
+void tb_axi4_scoreboard::print_stats(void) {
+  printf("SCOREBOARD: %llu writes, %llu reads, %llu bytes checked, "
+         "%llu errors\n",
+         (unsigned long long)m_writes, (unsigned long long)m_reads,
+         (unsigned long long)m_bytes_checked, (unsigned long long)m_errors);
+}
@@ -0,0 +1,60 @@
+#ifndef TB_AXI4_SCOREBOARD_H
+#define TB_AXI4_SCOREBOARD_H
+
+#include "tb_axi4_driver.h"
+#include "tb_memory.h"
+#include <deque>
+
+#define TB_SB_MAX_IDS (1 << AXI4_ID_W)
+
+//-------------------------------------------------------------
+// tb_axi4_scoreboard: Self-checking for non-blocking traffic
+//   Writes update the reference model when their B response
+//   arrives, reads are compared against it when their last R
+//   beat arrives. Bursts with the same ID (and direction) must
+//   complete in the order they were posted.
+//
+//   AXI gives no ordering between reads and writes, so posting
+//   a burst that overlaps an outstanding write (or a write that
+//   overlaps an outstanding read) would make the expected data
+//   ambiguous - hazard() reports this so the caller can hold it.
+//-------------------------------------------------------------
+class tb_axi4_scoreboard {
+public:
+  tb_axi4_scoreboard(tb_memory *model) {
+    m_model = model;
+    m_reads = 0;
+    m_writes = 0;
+    m_bytes_checked = 0;
+    m_errors = 0;
+  }
+
+  bool hazard(const tb_axi4_txn *txn);
+  void posted(tb_axi4_txn *txn);
+  void completed(tb_axi4_txn *txn);
+
+  int outstanding(void) { return (int)m_pending.size(); }
+  void print_stats(void);
+
+  // Address of a beat within a burst (FIXED / INCR / WRAP)
+  static uint32_t beat_addr(const tb_axi4_txn *txn, int beat);
+
+protected:
+  static bool overlap(const tb_axi4_txn *a, const tb_axi4_txn *b);
+  static void span(const tb_axi4_txn *txn, uint32_t &lo, uint32_t &hi);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  tb_memory *m_model;
+  std::deque<tb_axi4_txn *> m_pending;
+  std::deque<tb_axi4_txn *> m_order[2][TB_SB_MAX_IDS];
+
+  // Stats
+  uint64_t m_reads;
+  uint64_t m_writes;
+  uint64_t m_bytes_checked;
+  uint64_t m_errors;
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "tb_chrome_trace.h"
+
+// Clock cycle to trace timestamp (us)
+#define TB_TRACE_TS(c) ((double)(c) / SDRAM_MHZ)
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_chrome_trace::tb_chrome_trace() {
+  m_fp = NULL;
+  m_first = true;
+  m_last_cycle = 0;
+  m_trfc = (SDRAM_TRFC_NS * SDRAM_MHZ + 999) / 1000;
+
+  for (int d = 0; d < 2; d++)
+    for (int i = 0; i < (1 << AXI4_ID_W); i++)
+      m_axi_tracks[d][i] = false;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      m_row[c][b].open = false;
+}
+//-----------------------------------------------------------------
+// open: Start the trace file and name the SDRAM tracks
+//-----------------------------------------------------------------
+bool tb_chrome_trace::open(const char *filename) {
+  m_fp = fopen(filename, "w");
+  if (!m_fp) {
+    printf("ERROR: Could not open %s\n", filename);
+    return false;
+  }
+
+  fprintf(m_fp, "[");
+  m_first = true;
+
+  metadata("process_name", TB_TRACE_PID_AXI, 0, "AXI");
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    char name[32];
+    sprintf(name, "SDRAM%d", c);
+    metadata("process_name", TB_TRACE_PID_SDRAM + c, 0, name);
+    metadata("thread_name", TB_TRACE_PID_SDRAM + c, TB_TRACE_TID_SDRAM_CMD,
+             "commands");
+    metadata("thread_name", TB_TRACE_PID_SDRAM + c,
+             TB_TRACE_TID_SDRAM_REFRESH, "refresh");
+    for (int b = 0; b < SDRAM_BANKS; b++) {
+      sprintf(name, "bank %d", b);
+      metadata("thread_name", TB_TRACE_PID_SDRAM + c,
+               TB_TRACE_TID_SDRAM_BANK + b, name);
+    }
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------
+// close: Flush still open rows and terminate the array
+//-----------------------------------------------------------------
+void tb_chrome_trace::close(void) {
+  if (!m_fp)
+    return;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      close_row(c, b, m_last_cycle);
+
+  fprintf(m_fp, "\n]\n");
+  fclose(m_fp);
+  m_fp = NULL;
+}
+//-----------------------------------------------------------------
+// begin_event: Separator before the next event
+//-----------------------------------------------------------------
+void tb_chrome_trace::begin_event(void) {
+  fprintf(m_fp, m_first ? "\n" : ",\n");
+  m_first = false;
+}
+//-----------------------------------------------------------------
+// metadata: Process / thread (track) name
+//-----------------------------------------------------------------
+void tb_chrome_trace::metadata(const char *type, int pid, int tid,
+                               const char *name) {
+  begin_event();
+  fprintf(m_fp,
+          "{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,"
+          "\"args\":{\"name\":\"%s\"}}",
+          type, pid, tid, name);
+}
+//-----------------------------------------------------------------
+// slice: Complete event
+//-----------------------------------------------------------------
+void tb_chrome_trace::slice(int pid, int tid, const char *name,
+                            uint64_t start, uint64_t end) {
+  begin_event();
+  fprintf(m_fp,
+          "{\"ph\":\"X\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,"
+          "\"ts\":%.4f,\"dur\":%.4f}",
+          name, pid, tid, TB_TRACE_TS(start), TB_TRACE_TS(end - start));
+}
+//-----------------------------------------------------------------
+// instant: Thread scoped instant event
+//-----------------------------------------------------------------
+void tb_chrome_trace::instant(int pid, int tid, const char *name,
+                              uint64_t cycle) {
+  begin_event();
+  fprintf(m_fp,
+          "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,"
+          "\"ts\":%.4f}",
+          name, pid, tid, TB_TRACE_TS(cycle));
+}
+//-----------------------------------------------------------------
+// axi_burst: Slice from address handshake to last response
+//-----------------------------------------------------------------
+void tb_chrome_trace::axi_burst(bool write, int id, uint32_t addr, int len,
+                                uint64_t start, uint64_t end) {
+  if (!m_fp)
+    return;
+
+  int tid = (write ? TB_TRACE_TID_AXI_WRITE : 0) + id;
+  char name[64];
+
+  if (!m_axi_tracks[write][id]) {
+    m_axi_tracks[write][id] = true;
+    sprintf(name, "%s ID %d", write ? "write" : "read", id);
+    metadata("thread_name", TB_TRACE_PID_AXI, tid, name);
+  }
+
+  sprintf(name, "%s 0x%08x x%d", write ? "WR" : "RD", addr, len + 1);
+  slice(TB_TRACE_PID_AXI, tid, name, start, end);
+}
+//-----------------------------------------------------------------
+// close_row: Emit the row open slice for a bank
+//-----------------------------------------------------------------
+void tb_chrome_trace::close_row(int chip, int bank, uint64_t cycle) {
+  row_state &r = m_row[chip][bank];
+  if (!r.open)
+    return;
+
+  char name[32];
+  sprintf(name, "row 0x%x", r.row);
+  slice(TB_TRACE_PID_SDRAM + chip, TB_TRACE_TID_SDRAM_BANK + bank, name,
+        r.act, cycle);
+  r.open = false;
+}
+//-----------------------------------------------------------------
+// sdram_cycle: Command instants, refresh and row slices
+//-----------------------------------------------------------------
+void tb_chrome_trace::sdram_cycle(int chip, uint64_t cycle, int cmd,
+                                  const sdram_io &io) {
+  m_last_cycle = cycle;
+
+  if (!m_fp || cmd == SDRAM_CMD_NOP)
+    return;
+
+  int pid = TB_TRACE_PID_SDRAM + chip;
+  int bank = (int)io.BA;
+  bool a10 = (io.ADDR >> SDRAM_AUTO_PRECHARGE_BIT) & 1;
+
+  switch (cmd) {
+  case SDRAM_CMD_ACTIVE:
+    close_row(chip, bank, cycle);
+    m_row[chip][bank].open = true;
+    m_row[chip][bank].row = (uint32_t)io.ADDR;
+    m_row[chip][bank].act = cycle;
+    break;
+  case SDRAM_CMD_READ:
+  case SDRAM_CMD_WRITE:
+    if (a10)
+      close_row(chip, bank, cycle + SDRAM_BURST_LEN);
+    break;
+  case SDRAM_CMD_PRECHARGE:
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      if (a10 || b == bank)
+        close_row(chip, b, cycle);
+    break;
+  case SDRAM_CMD_REFRESH:
+    slice(pid, TB_TRACE_TID_SDRAM_REFRESH, "REF", cycle, cycle + m_trfc);
+    break;
+  default:
+    break;
+  }
+
+  char name[32];
+  if (cmd == SDRAM_CMD_ACTIVE || cmd == SDRAM_CMD_READ ||
+      cmd == SDRAM_CMD_WRITE ||
+      (cmd == SDRAM_CMD_PRECHARGE && !a10))
+    sprintf(name, "%s b%d", sdram_io::command_name(cmd), bank);
+  else
+    sprintf(name, "%s", sdram_io::command_name(cmd));
+  instant(pid, TB_TRACE_TID_SDRAM_CMD, name, cycle);
+}
@@ -0,0 +1,73 @@
+#ifndef TB_CHROME_TRACE_H
+#define TB_CHROME_TRACE_H
+
+#include "axi4_defines.h"
+#include "tb_sdram_monitor.h"
+#include <stdio.h>
+
+//--------------------------------------------------------------------
+// Track layout (pid / tid)
+//--------------------------------------------------------------------
+#define TB_TRACE_PID_AXI 1
+#define TB_TRACE_PID_SDRAM 2 // + chip
+
+#define TB_TRACE_TID_AXI_WRITE 64 // + ID (reads use tid = ID)
+
+#define TB_TRACE_TID_SDRAM_CMD 0
+#define TB_TRACE_TID_SDRAM_REFRESH 1
+#define TB_TRACE_TID_SDRAM_BANK 2 // + bank
+
+//-------------------------------------------------------------
+// tb_chrome_trace: Trace event writer (Chrome JSON array format)
+//   Opens in Perfetto UI or chrome://tracing. Events are written
+//   as they complete, so memory use does not grow with the run;
+//   the array format also loads if the run dies before close().
+//   Timestamps are in us, derived from the SDRAM clock.
+//
+//   AXI bursts: slice per burst, AR / AW handshake to last R / B,
+//   on a per direction + ID track.
+//   SDRAM: command instants per chip, refresh slices (tRFC) and
+//   row open slices (ACT to PRE) per bank.
+//-------------------------------------------------------------
+class tb_chrome_trace : public tb_sdram_observer {
+public:
+  tb_chrome_trace();
+  ~tb_chrome_trace() { close(); }
+
+  bool open(const char *filename);
+  void close(void);
+  bool enabled(void) { return m_fp != NULL; }
+
+  // AXI burst completed
+  void axi_burst(bool write, int id, uint32_t addr, int len, uint64_t start,
+                 uint64_t end);
+
+  void sdram_cycle(int chip, uint64_t cycle, int cmd, const sdram_io &io);
+
+protected:
+  void begin_event(void);
+  void slice(int pid, int tid, const char *name, uint64_t start,
+             uint64_t end);
+  void instant(int pid, int tid, const char *name, uint64_t cycle);
+  void metadata(const char *type, int pid, int tid, const char *name);
+  void close_row(int chip, int bank, uint64_t cycle);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  FILE *m_fp;
+  bool m_first;
+  uint64_t m_last_cycle;
+  bool m_axi_tracks[2][1 << AXI4_ID_W];
+
+  // Open row per bank (for row slices)
+  struct row_state {
+    bool open;
+    uint32_t row;
+    uint64_t act;
+  };
+  row_state m_row[SDRAM_CHIPS][SDRAM_BANKS];
+  int m_trfc;
+};
+
+#endif
@@ -0,0 +1,356 @@
+#include "tb_coverage.h"
+
+//-----------------------------------------------------------------
+// SdramCore transitions that make up the state coverage goal
+//-----------------------------------------------------------------
+static const int g_transitions[][2] = {
+    {SDRAM_STATE_INIT, SDRAM_STATE_IDLE},
+    {SDRAM_STATE_IDLE, SDRAM_STATE_REFRESH},   // Refresh, all banks closed
+    {SDRAM_STATE_IDLE, SDRAM_STATE_PRECHARGE}, // Refresh, rows open
+    {SDRAM_STATE_IDLE, SDRAM_STATE_READ},      // Row open (bank scheduler)
+    {SDRAM_STATE_IDLE, SDRAM_STATE_WRITE0},    // Row open (bank scheduler)
+    {SDRAM_STATE_DELAY, SDRAM_STATE_IDLE},
+    {SDRAM_STATE_DELAY, SDRAM_STATE_REFRESH},
+    {SDRAM_STATE_READ, SDRAM_STATE_READ_WAIT},
+    {SDRAM_STATE_READ_WAIT, SDRAM_STATE_READ_BURST},
+    {SDRAM_STATE_READ_BURST, SDRAM_STATE_READ_WAIT}, // Streamed read
+    {SDRAM_STATE_READ_BURST, SDRAM_STATE_DELAY},     // CAS latency left
+    {SDRAM_STATE_READ_BURST, SDRAM_STATE_IDLE},      // After lingering
+    {SDRAM_STATE_WRITE0, SDRAM_STATE_WRITE1},
+    {SDRAM_STATE_WRITE1, SDRAM_STATE_WRITE_BURST},
+    {SDRAM_STATE_WRITE_BURST, SDRAM_STATE_WRITE1}, // Streamed write
+    {SDRAM_STATE_WRITE_BURST, SDRAM_STATE_IDLE},
+    {SDRAM_STATE_PRECHARGE, SDRAM_STATE_DELAY},
+    {SDRAM_STATE_REFRESH, SDRAM_STATE_DELAY},
+};
+
+static const char *g_row_names[TB_COV_ROW_MAX] = {"hit", "closed",
+                                                  "conflict"};
+static const char *g_burst_names[] = {"FIXED", "INCR", "WRAP"};
+static const char *g_len_names[TB_COV_LEN_BINS] = {"1", "2", "4",
+                                                   "8", "16", "other"};
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_coverage::tb_coverage(sc_module_name name) : sc_module(name) {
+  SC_CTHREAD(process, clk_in.pos());
+
+  memset(m_state, 0, sizeof(m_state));
+  memset(m_row, 0, sizeof(m_row));
+  memset(m_bank_pre, 0, sizeof(m_bank_pre));
+  memset(m_burst, 0, sizeof(m_burst));
+  memset(m_len, 0, sizeof(m_len));
+  memset(m_strb, 0, sizeof(m_strb));
+
+  m_plateau = 0;
+  m_since_new = 0;
+  m_stopped = false;
+
+  char bin[64];
+  int count = sizeof(g_transitions) / sizeof(g_transitions[0]);
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    m_last_state[c] = SDRAM_STATE_INIT;
+    for (int i = 0; i < count; i++) {
+      int from = g_transitions[i][0];
+      int to = g_transitions[i][1];
+      sprintf(bin, "state.chip%d.%s>%s", c,
+              sdram_core_debug::state_name(from),
+              sdram_core_debug::state_name(to));
+      add_goal(bin, &m_state[c][from][to]);
+    }
+    for (int r = 0; r < TB_COV_ROW_MAX; r++) {
+      sprintf(bin, "row.chip%d.%s", c, g_row_names[r]);
+      add_goal(bin, &m_row[c][r]);
+    }
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      m_bank_next[c][b] = TB_COV_ROW_CLOSED;
+  }
+
+  for (int d = 0; d < 2; d++) {
+    const char *dir = d ? "write" : "read";
+    for (int t = 0; t < 3; t++) {
+      sprintf(bin, "burst.%s.%s", dir, g_burst_names[t]);
+      add_goal(bin, &m_burst[d][t]);
+    }
+    for (int l = 0; l < TB_COV_LEN_BINS; l++) {
+      sprintf(bin, "len.%s.%s", dir, g_len_names[l]);
+      add_goal(bin, &m_len[d][l]);
+    }
+  }
+
+  for (int s = 0; s < 16; s++) {
+    sprintf(bin, "strb.0x%x", s);
+    add_goal(bin, &m_strb[s]);
+  }
+}
+//-----------------------------------------------------------------
+// add_goal: Register a named bin
+//-----------------------------------------------------------------
+void tb_coverage::add_goal(const std::string &bin, uint64_t *count) {
+  goal g;
+  g.bin = bin;
+  g.count = count;
+  m_goals.push_back(g);
+}
+//-----------------------------------------------------------------
+// len_bin: AXI length bin (power of two beats, or other)
+//-----------------------------------------------------------------
+int tb_coverage::len_bin(int len) {
+  switch (len + 1) {
+  case 1:
+    return 0;
+  case 2:
+    return 1;
+  case 4:
+    return 2;
+  case 8:
+    return 3;
+  case 16:
+    return 4;
+  default:
+    return 5;
+  }
+}
+//-----------------------------------------------------------------
+// new_bin: A goal bin was hit for the first time in this run
+//-----------------------------------------------------------------
+void tb_coverage::new_bin(void) { m_since_new = 0; }
+//-----------------------------------------------------------------
+// sdram_cycle: Classify RD / WR by the bank commands before them
+//-----------------------------------------------------------------
+void tb_coverage::sdram_cycle(int chip, uint64_t, int cmd,
+                              const sdram_io &io) {
+  int bank = (int)io.BA;
+
+  switch (cmd) {
+  case SDRAM_CMD_ACTIVE:
+    m_bank_next[chip][bank] =
+        m_bank_pre[chip][bank] ? TB_COV_ROW_CONFLICT : TB_COV_ROW_CLOSED;
+    m_bank_pre[chip][bank] = false;
+    break;
+  case SDRAM_CMD_PRECHARGE:
+    // PRE all is the refresh path, the banks are simply closed after it
+    if ((io.ADDR >> SDRAM_AUTO_PRECHARGE_BIT) & 1)
+      for (int b = 0; b < SDRAM_BANKS; b++)
+        m_bank_pre[chip][b] = false;
+    else
+      m_bank_pre[chip][bank] = true;
+    break;
+  case SDRAM_CMD_READ:
+  case SDRAM_CMD_WRITE:
+    if (m_row[chip][m_bank_next[chip][bank]]++ == 0)
+      new_bin();
+    m_bank_next[chip][bank] = TB_COV_ROW_HIT;
+    break;
+  default:
+    break;
+  }
+}
+//-----------------------------------------------------------------
+// process: Sample every clock
+//-----------------------------------------------------------------
+void tb_coverage::process(void) {
+  bool legal[SDRAM_STATE_MAX][SDRAM_STATE_MAX];
+  memset(legal, 0, sizeof(legal));
+  int count = sizeof(g_transitions) / sizeof(g_transitions[0]);
+  for (int i = 0; i < count; i++)
+    legal[g_transitions[i][0]][g_transitions[i][1]] = true;
+
+  while (true) {
+    wait();
+
+    if (rst_in.read())
+      continue;
+
+    // SdramCore transitions
+    for (int c = 0; c < SDRAM_CHIPS; c++) {
+      int state = (int)core_in[c].read().STATE;
+      int last = m_last_state[c];
+      if (state == last || state >= SDRAM_STATE_MAX)
+        continue;
+
+      if (m_state[c][last][state]++ == 0 && legal[last][state])
+        new_bin();
+      m_last_state[c] = state;
+    }
+
+    axi4_master m = axi_m_in.read();
+    axi4_slave s = axi_s_in.read();
+    int bursts = 0;
+
+    // Burst type / length
+    if (m.ARVALID && s.ARREADY) {
+      if (m.ARBURST < 3 && m_burst[0][m.ARBURST]++ == 0)
+        new_bin();
+      if (m_len[0][len_bin(m.ARLEN)]++ == 0)
+        new_bin();
+      bursts++;
+    }
+    if (m.AWVALID && s.AWREADY) {
+      if (m.AWBURST < 3 && m_burst[1][m.AWBURST]++ == 0)
+        new_bin();
+      if (m_len[1][len_bin(m.AWLEN)]++ == 0)
+        new_bin();
+      bursts++;
+    }
+
+    // Write strobes, per 32-bit word of the beat
+    if (m.WVALID && s.WREADY)
+      for (int w = 0; w < AXI4_STRB_W / 4; w++)
+        if (m_strb[(m.WSTRB >> (4 * w)) & 0xF]++ == 0)
+          new_bin();
+
+    // Plateau: stop the traffic once coverage stops growing
+    m_since_new += bursts;
+    if (m_plateau > 0 && !m_stopped && m_since_new >= (uint64_t)m_plateau) {
+      printf("COVERAGE: No new bins for %d bursts, stopping traffic\n",
+             m_plateau);
+      for (size_t i = 0; i < m_sequencers.size(); i++)
+        m_sequencers[i]->stop();
+      m_stopped = true;
+    }
+  }
+}
+//-----------------------------------------------------------------
+// load: Merge counts from a previous run (missing file is empty)
+//-----------------------------------------------------------------
+bool tb_coverage::load(const char *filename) {
+  FILE *f = fopen(filename, "r");
+  if (!f) {
+    m_filename = filename;
+    return true;
+  }
+
+  char line[256];
+  int line_no = 0;
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), f)) {
+    line_no++;
+
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = 0;
+
+    char bin[128], count[32];
+    int n = sscanf(line, "%127s %31s", bin, count);
+    if (n <= 0)
+      continue;
+    if (n < 2) {
+      printf("ERROR: %s:%d: Expected 'bin count'\n", filename, line_no);
+      ok = false;
+      break;
+    }
+    m_merged[bin] += strtoull(count, NULL, 0);
+  }
+
+  fclose(f);
+
+  // Only save back to a file that parsed, never overwrite a bad one
+  if (ok)
+    m_filename = filename;
+  return ok;
+}
+//-----------------------------------------------------------------
+// save: Write merged totals (previous runs + this run)
+//-----------------------------------------------------------------
+bool tb_coverage::save(void) {
+  if (m_filename.empty())
+    return true;
+
+  std::map<std::string, uint64_t> total = m_merged;
+  for (size_t i = 0; i < m_goals.size(); i++)
+    total[m_goals[i].bin] += *m_goals[i].count;
+
+  FILE *f = fopen(m_filename.c_str(), "w");
+  if (!f) {
+    printf("ERROR: Could not open %s\n", m_filename.c_str());
+    return false;
+  }
+
+  fprintf(f, "# bin count (merged over runs)\n");
+  std::map<std::string, uint64_t>::iterator it;
+  for (it = total.begin(); it != total.end(); ++it)
+    fprintf(f, "%s %llu\n", it->first.c_str(),
+            (unsigned long long)it->second);
+
+  fclose(f);
+  return true;
+}
+//-----------------------------------------------------------------
+// hit: Goal bins hit in this run
+//-----------------------------------------------------------------
+int tb_coverage::hit(void) {
+  int n = 0;
+  for (size_t i = 0; i < m_goals.size(); i++)
+    if (*m_goals[i].count)
+      n++;
+  return n;
+}
+//-----------------------------------------------------------------
+// hit_merged: Goal bins hit in this or any merged run
+//-----------------------------------------------------------------
+int tb_coverage::hit_merged(void) {
+  int n = 0;
+  for (size_t i = 0; i < m_goals.size(); i++) {
+    std::map<std::string, uint64_t>::iterator it =
+        m_merged.find(m_goals[i].bin);
+    if (*m_goals[i].count || (it != m_merged.end() && it->second))
+      n++;
+  }
+  return n;
+}
+//-----------------------------------------------------------------
+// print_stats: Summary and missed bins to stdout
+//-----------------------------------------------------------------
+void tb_coverage::print_stats(void) {
+  int total = goals();
+  int run = hit();
+  int merged = hit_merged();
+
+  printf("COVERAGE: %d / %d bins (%.1f%%) this run", run, total,
+         total ? (100.0 * run) / total : 0.0);
+  if (!m_filename.empty())
+    printf(", %d / %d (%.1f%%) merged", merged, total,
+           total ? (100.0 * merged) / total : 0.0);
+  printf("\n");
+
+  for (size_t i = 0; i < m_goals.size(); i++) {
+    std::map<std::string, uint64_t>::iterator it =
+        m_merged.find(m_goals[i].bin);
+    if (!*m_goals[i].count && (it == m_merged.end() || !it->second))
+      printf("COVERAGE:   missed %s\n", m_goals[i].bin.c_str());
+  }
+
+  // Transitions outside the goal (FSM changed or broken)
+  int count = sizeof(g_transitions) / sizeof(g_transitions[0]);
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    for (int a = 0; a < SDRAM_STATE_MAX; a++)
+      for (int b = 0; b < SDRAM_STATE_MAX; b++) {
+        if (!m_state[c][a][b])
+          continue;
+        bool legal = false;
+        for (int i = 0; i < count && !legal; i++)
+          legal = (g_transitions[i][0] == a && g_transitions[i][1] == b);
+        if (!legal)
+          printf("COVERAGE:   unexpected chip%d %s>%s (%llu)\n", c,
+                 sdram_core_debug::state_name(a),
+                 sdram_core_debug::state_name(b),
+                 (unsigned long long)m_state[c][a][b]);
+      }
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_coverage::write_json(tb_json &js) {
+  js.value("goals", goals());
+  js.value("hit", hit());
+  js.value("hit_merged", hit_merged());
+  js.value("plateau_stop", m_stopped);
+
+  js.begin_object("bins");
+  for (size_t i = 0; i < m_goals.size(); i++)
+    js.value(m_goals[i].bin.c_str(), *m_goals[i].count);
+  js.end_object();
+}
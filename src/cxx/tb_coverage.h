@@ -0,0 +1,120 @@
+#ifndef TB_COVERAGE_H
+#define TB_COVERAGE_H
+
+#include "axi4.h"
+#include "axi4_defines.h"
+#include "sdram_defines.h"
+#include "sdram_io.h"
+#include "tb_json.h"
+#include "tb_mem_test.h"
+#include "tb_sdram_monitor.h"
+#include <map>
+#include <string>
+#include <vector>
+
+#define TB_COV_LEN_BINS 6 // 1, 2, 4, 8, 16, other
+
+// How a RD / WR found its bank (from the command bus)
+enum eTB_COV_ROW {
+  TB_COV_ROW_HIT,      // Row already open and accessed
+  TB_COV_ROW_CLOSED,   // ACT of a closed bank first
+  TB_COV_ROW_CONFLICT, // PRE of another row, then ACT
+  TB_COV_ROW_MAX
+};
+
+//-------------------------------------------------------------
+// tb_coverage: Functional coverage (passive, counters only)
+//   SdramCore state transitions per chip, row hit / closed bank
+//   / row conflict accesses per chip (the bank scheduler's ACT,
+//   or PRE + ACT, ahead of a RD / WR on the command bus), AXI
+//   burst type and length per direction, and write strobe
+//   patterns per 32-bit word of the beat, all sampled from the
+//   DUT port signals.
+//
+//   Results can be merged with a coverage file from earlier
+//   runs (one 'bin count' per line); the merged totals are
+//   written back at the end. Optionally stops the sequencers
+//   once no new bin has been hit for N bursts.
+//-------------------------------------------------------------
+class tb_coverage : public sc_module, public tb_sdram_observer {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  sc_in<axi4_master> axi_m_in;
+  sc_in<axi4_slave> axi_s_in;
+
+  sc_in<sdram_core_debug> core_in[SDRAM_CHIPS];
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_coverage);
+  tb_coverage(sc_module_name name);
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  // Merge with (and later rewrite) a coverage file
+  bool load(const char *filename);
+  bool save(void);
+
+  // Stop these sequencers after 'bursts' bursts without a new bin
+  void set_plateau(int bursts) { m_plateau = bursts; }
+  void add_sequencer(tb_mem_test *seq) { m_sequencers.push_back(seq); }
+  bool plateaued(void) { return m_stopped; }
+
+  int goals(void) { return (int)m_goals.size(); }
+  int hit(void);
+  int hit_merged(void);
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+  // tb_sdram_observer (added to each chip's tb_sdram_monitor)
+  void sdram_cycle(int chip, uint64_t cycle, int cmd, const sdram_io &io);
+
+protected:
+  void process(void);
+  void add_goal(const std::string &bin, uint64_t *count);
+  void new_bin(void);
+  static int len_bin(int len);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  int m_last_state[SDRAM_CHIPS];
+
+  // Per bank: what the next RD / WR counts as, single bank PRE seen
+  int m_bank_next[SDRAM_CHIPS][SDRAM_BANKS];
+  bool m_bank_pre[SDRAM_CHIPS][SDRAM_BANKS];
+
+  // Counters (this run)
+  uint64_t m_state[SDRAM_CHIPS][SDRAM_STATE_MAX][SDRAM_STATE_MAX];
+  uint64_t m_row[SDRAM_CHIPS][TB_COV_ROW_MAX];
+  uint64_t m_burst[2][3];
+  uint64_t m_len[2][TB_COV_LEN_BINS];
+  uint64_t m_strb[16];
+
+  // Named bins that make up the coverage goal
+  struct goal {
+    std::string bin;
+    uint64_t *count;
+  };
+  std::vector<goal> m_goals;
+
+  // Counts from earlier runs (by bin name)
+  std::map<std::string, uint64_t> m_merged;
+  std::string m_filename;
+
+  // Plateau detection
+  int m_plateau;
+  uint64_t m_since_new;
+  bool m_stopped;
+  std::vector<tb_mem_test *> m_sequencers;
+};
+
+#endif
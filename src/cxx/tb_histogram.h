@@ -0,0 +1,95 @@
+#ifndef TB_HISTOGRAM_H
+#define TB_HISTOGRAM_H
+
+#include "tb_json.h"
+#include <cstdint>
+#include <math.h>
+#include <vector>
+
+//-------------------------------------------------------------
+// tb_histogram: Linear histogram of cycle counts with percentiles.
+// Samples above the bucket range are counted in an overflow bin
+// (exact max is still tracked).
+//-------------------------------------------------------------
+class tb_histogram {
+public:
+  tb_histogram(int buckets = 4096) : m_bins(buckets, 0) { reset(); }
+
+  void reset(void) {
+    for (size_t i = 0; i < m_bins.size(); i++)
+      m_bins[i] = 0;
+    m_overflow = 0;
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+  }
+
+  void add(uint64_t v) {
+    if (v < m_bins.size())
+      m_bins[v]++;
+    else
+      m_overflow++;
+    m_count++;
+    m_sum += v;
+    if (v > m_max)
+      m_max = v;
+  }
+
+  uint64_t count(void) const { return m_count; }
+  uint64_t max(void) const { return m_max; }
+  double mean(void) const { return m_count ? (double)m_sum / m_count : 0.0; }
+
+  // Smallest value with at least pct% of samples at or below it
+  uint64_t percentile(double pct) const {
+    if (!m_count)
+      return 0;
+
+    uint64_t target = (uint64_t)ceil((pct / 100.0) * m_count);
+    if (target == 0)
+      target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_bins.size(); i++) {
+      seen += m_bins[i];
+      if (seen >= target)
+        return i;
+    }
+    return m_max;
+  }
+
+  void print(const char *name) const {
+    printf("%s: count %llu mean %.1f p50 %llu p90 %llu p99 %llu max %llu\n",
+           name, (unsigned long long)m_count, mean(),
+           (unsigned long long)percentile(50),
+           (unsigned long long)percentile(90),
+           (unsigned long long)percentile(99), (unsigned long long)m_max);
+  }
+
+  void write_json(tb_json &js, const char *key) const {
+    js.begin_object(key);
+    js.value("count", m_count);
+    js.value("mean", mean());
+    js.value("p50", percentile(50));
+    js.value("p90", percentile(90));
+    js.value("p99", percentile(99));
+    js.value("max", m_max);
+    js.value("overflow", m_overflow);
+
+    // Sparse [value, count] pairs
+    js.begin_array("histogram");
+    for (size_t i = 0; i < m_bins.size(); i++)
+      if (m_bins[i])
+        js.pair(i, m_bins[i]);
+    js.end_array();
+    js.end_object();
+  }
+
+protected:
+  std::vector<uint64_t> m_bins;
+  uint64_t m_overflow;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_max;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef TB_JSON_H
+#define TB_JSON_H
+
+#include <cstdint>
+#include <stdio.h>
+
+#define TB_JSON_MAX_DEPTH 16
+
+//-------------------------------------------------------------
+// tb_json: Minimal streaming JSON writer (for result reports)
+//-------------------------------------------------------------
+class tb_json {
+public:
+  tb_json(FILE *fp) {
+    m_fp = fp;
+    m_depth = 0;
+    m_first[0] = true;
+  }
+
+  void begin_object(const char *key = NULL) { open(key, '{'); }
+  void end_object(void) { close('}'); }
+  void begin_array(const char *key = NULL) { open(key, '['); }
+  void end_array(void) { close(']'); }
+
+  void value(const char *key, const char *v) {
+    item(key);
+    fputc('"', m_fp);
+    for (; v && *v; v++) {
+      if (*v == '"' || *v == '\\')
+        fputc('\\', m_fp);
+      fputc(*v, m_fp);
+    }
+    fputc('"', m_fp);
+  }
+  void value(const char *key, bool v) {
+    item(key);
+    fprintf(m_fp, v ? "true" : "false");
+  }
+  void value(const char *key, int v) {
+    item(key);
+    fprintf(m_fp, "%d", v);
+  }
+  void value(const char *key, uint32_t v) {
+    item(key);
+    fprintf(m_fp, "%u", v);
+  }
+  void value(const char *key, uint64_t v) {
+    item(key);
+    fprintf(m_fp, "%llu", (unsigned long long)v);
+  }
+  void value(const char *key, double v) {
+    item(key);
+    fprintf(m_fp, "%.6g", v);
+  }
+
+  // Array element helpers
+  void value(uint64_t v) { value(NULL, v); }
+  void value(double v) { value(NULL, v); }
+  void pair(uint64_t a, uint64_t b) {
+    item(NULL);
+    fprintf(m_fp, "[%llu, %llu]", (unsigned long long)a,
+            (unsigned long long)b);
+  }
+
+protected:
+  void item(const char *key) {
+    if (!m_first[m_depth])
+      fputc(',', m_fp);
+    m_first[m_depth] = false;
+    fputc('\n', m_fp);
+    for (int i = 0; i < m_depth; i++)
+      fputs("  ", m_fp);
+    if (key)
+      fprintf(m_fp, "\"%s\": ", key);
+  }
+
+  void open(const char *key, char c) {
+    if (m_depth > 0)
+      item(key);
+    fputc(c, m_fp);
+    if (m_depth < TB_JSON_MAX_DEPTH - 1)
+      m_depth++;
+    m_first[m_depth] = true;
+  }
+
+  void close(char c) {
+    bool empty = m_first[m_depth];
+    if (m_depth > 0)
+      m_depth--;
+    if (!empty) {
+      fputc('\n', m_fp);
+      for (int i = 0; i < m_depth; i++)
+        fputs("  ", m_fp);
+    }
+    fputc(c, m_fp);
+    if (m_depth == 0)
+      fputc('\n', m_fp);
+  }
+
+protected:
+  FILE *m_fp;
+  int m_depth;
+  bool m_first[TB_JSON_MAX_DEPTH];
+};
+
+#endif
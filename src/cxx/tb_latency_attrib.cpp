@@ -0,0 +1,307 @@
+#include "tb_latency_attrib.h"
+
+// Per cycle history flags (4 per chip, then the front-end)
+#define LAT_CHIP_REFRESH(c) (1u << ((c) * 4 + 0))
+#define LAT_CHIP_ROW_MISS(c) (1u << ((c) * 4 + 1))
+#define LAT_CHIP_READ(c) (1u << ((c) * 4 + 2))
+#define LAT_CHIP_WRITE(c) (1u << ((c) * 4 + 3))
+#define LAT_R_ARB_LOSS (1u << 16)
+#define LAT_W_ARB_LOSS (1u << 17)
+#define LAT_R_TURNAROUND (1u << 18)
+#define LAT_W_TURNAROUND (1u << 19)
+#define LAT_PENDING_VALID (1u << 20)
+#define LAT_PENDING_CHIP (1u << 21)
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_latency_attrib::tb_latency_attrib(sc_module_name name) : sc_module(name) {
+  SC_CTHREAD(process, clk_in.pos());
+
+  m_threshold = 0;
+  m_cycle = 0;
+  m_bursts = 0;
+  m_outliers = 0;
+  m_latency = 0;
+  m_truncated = 0;
+  memset(m_history, 0, sizeof(m_history));
+  memset(m_cycles, 0, sizeof(m_cycles));
+  memset(m_dominant, 0, sizeof(m_dominant));
+}
+//-----------------------------------------------------------------
+// cause_name: Printable cause
+//-----------------------------------------------------------------
+const char *tb_latency_attrib::cause_name(int cause) {
+  switch (cause) {
+  case TB_LAT_REFRESH:
+    return "refresh";
+  case TB_LAT_ROW_MISS:
+    return "row_miss";
+  case TB_LAT_TURNAROUND:
+    return "turnaround";
+  case TB_LAT_ARB_LOSS:
+    return "arb_loss";
+  case TB_LAT_OTHER_CHIP:
+    return "other_chip";
+  case TB_LAT_OTHER:
+    return "other";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// sample: Controller state flags for this cycle
+//-----------------------------------------------------------------
+uint32_t tb_latency_attrib::sample(void) {
+  uint32_t flags = 0;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    sdram_core_debug d = core_in[c].read();
+    int state = (int)d.STATE;
+    int target = (int)d.TARGET;
+    bool for_refresh = (target == SDRAM_STATE_REFRESH);
+
+    // Head request waiting on the bank scheduler (ACT / PRE, tRP, tRCD)
+    if (d.BANK_WAIT && !for_refresh)
+      flags |= LAT_CHIP_ROW_MISS(c);
+
+    switch (state) {
+    case SDRAM_STATE_REFRESH:
+      flags |= LAT_CHIP_REFRESH(c);
+      break;
+    case SDRAM_STATE_PRECHARGE:
+      flags |= LAT_CHIP_REFRESH(c);
+      break;
+    case SDRAM_STATE_READ:
+    case SDRAM_STATE_READ_WAIT:
+    case SDRAM_STATE_READ_BURST:
+      flags |= LAT_CHIP_READ(c);
+      break;
+    case SDRAM_STATE_WRITE0:
+    case SDRAM_STATE_WRITE1:
+    case SDRAM_STATE_WRITE_BURST:
+      flags |= LAT_CHIP_WRITE(c);
+      break;
+    case SDRAM_STATE_DELAY:
+      // tRP before refresh, tRFC after it (delay back to idle)
+      if (for_refresh)
+        flags |= LAT_CHIP_REFRESH(c);
+      // CAS latency after the last read
+      else
+        flags |= LAT_CHIP_READ(c);
+      break;
+    default:
+      break;
+    }
+  }
+
+  sdram_ctrl_debug ctrl = ctrl_in.read();
+  if (ctrl.R_ARB_LOSS)
+    flags |= LAT_R_ARB_LOSS;
+  if (ctrl.W_ARB_LOSS)
+    flags |= LAT_W_ARB_LOSS;
+  if (ctrl.R_TURNAROUND)
+    flags |= LAT_R_TURNAROUND;
+  if (ctrl.W_TURNAROUND)
+    flags |= LAT_W_TURNAROUND;
+  if (ctrl.PENDING_VALID)
+    flags |= LAT_PENDING_VALID;
+  if (ctrl.PENDING_CHIP)
+    flags |= LAT_PENDING_CHIP;
+
+  return flags;
+}
+//-----------------------------------------------------------------
+// burst_chips: Chips an AXI burst touches (bit per chip)
+//-----------------------------------------------------------------
+int tb_latency_attrib::burst_chips(uint32_t addr, int len, int type) {
+  if (type == AXI4_BURST_FIXED)
+    return tb_sdram_map::chip_mask(addr, 1);
+
+  // WRAP covers its aligned block whatever the start
+  if (type == AXI4_BURST_WRAP)
+    addr &= ~((uint32_t)(len + 1) * AXI4_STRB_W - 1);
+  return tb_sdram_map::chip_mask(addr, len + 1);
+}
+//-----------------------------------------------------------------
+// classify: Charge one cycle of a burst to a single cause
+//-----------------------------------------------------------------
+int tb_latency_attrib::classify(uint32_t flags, bool write, int chips) {
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    if ((chips & (1 << c)) && (flags & LAT_CHIP_REFRESH(c)))
+      return TB_LAT_REFRESH;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    if ((chips & (1 << c)) && (flags & LAT_CHIP_ROW_MISS(c)))
+      return TB_LAT_ROW_MISS;
+
+  if (flags & (write ? LAT_W_TURNAROUND : LAT_R_TURNAROUND))
+    return TB_LAT_TURNAROUND;
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    if ((chips & (1 << c)) &&
+        (flags & (write ? LAT_CHIP_READ(c) : LAT_CHIP_WRITE(c))))
+      return TB_LAT_TURNAROUND;
+
+  if (flags & (write ? LAT_W_ARB_LOSS : LAT_R_ARB_LOSS))
+    return TB_LAT_ARB_LOSS;
+
+  // Only meaningful for single chip bursts; bursts over both chips
+  // always wait on both in turn
+  if ((flags & LAT_PENDING_VALID) && (chips & (chips - 1)) == 0) {
+    int head = (flags & LAT_PENDING_CHIP) ? 1 : 0;
+    if (!(chips & (1 << head)))
+      return TB_LAT_OTHER_CHIP;
+  }
+
+  return TB_LAT_OTHER;
+}
+//-----------------------------------------------------------------
+// complete: Burst finished, attribute it if over the threshold
+//-----------------------------------------------------------------
+void tb_latency_attrib::complete(bool write, int id, uint64_t cycle) {
+  std::deque<burst> &q = write ? m_wr_pending[id] : m_rd_pending[id];
+  sc_assert(!q.empty());
+  burst b = q.front();
+  q.pop_front();
+
+  m_bursts++;
+  uint64_t latency = cycle - b.cycle;
+  if (latency < (uint64_t)m_threshold)
+    return;
+
+  outlier o;
+  o.write = write;
+  o.id = id;
+  o.addr = b.addr;
+  o.len = b.len;
+  o.cycle = b.cycle;
+  o.latency = latency;
+  memset(o.cycles, 0, sizeof(o.cycles));
+
+  // Older cycles have left the history
+  uint64_t first = b.cycle;
+  if (latency > TB_LAT_HISTORY) {
+    first = cycle - TB_LAT_HISTORY;
+    o.cycles[TB_LAT_OTHER] += first - b.cycle;
+    m_truncated++;
+  }
+
+  for (uint64_t c = first; c < cycle; c++)
+    o.cycles[classify(m_history[c % TB_LAT_HISTORY], write, b.chips)]++;
+
+  int dominant = 0;
+  for (int i = 0; i < TB_LAT_MAX; i++) {
+    m_cycles[i] += o.cycles[i];
+    if (o.cycles[i] > o.cycles[dominant])
+      dominant = i;
+  }
+  m_dominant[dominant]++;
+  m_outliers++;
+  m_latency += latency;
+
+  if (m_details.size() < TB_LAT_MAX_DETAILS)
+    m_details.push_back(o);
+}
+//-----------------------------------------------------------------
+// process: Record controller state, track bursts
+//-----------------------------------------------------------------
+void tb_latency_attrib::process(void) {
+  while (true) {
+    wait();
+
+    if (rst_in.read() || !enabled())
+      continue;
+
+    m_history[m_cycle % TB_LAT_HISTORY] = sample();
+
+    axi4_master m = axi_m_in.read();
+    axi4_slave s = axi_s_in.read();
+
+    if (m.ARVALID && s.ARREADY) {
+      burst b;
+      b.cycle = m_cycle;
+      b.addr = (uint32_t)m.ARADDR;
+      b.len = (int)m.ARLEN;
+      b.chips = burst_chips(b.addr, b.len, m.ARBURST);
+      m_rd_pending[m.ARID].push_back(b);
+    }
+    if (m.AWVALID && s.AWREADY) {
+      burst b;
+      b.cycle = m_cycle;
+      b.addr = (uint32_t)m.AWADDR;
+      b.len = (int)m.AWLEN;
+      b.chips = burst_chips(b.addr, b.len, m.AWBURST);
+      m_wr_pending[m.AWID].push_back(b);
+    }
+
+    if (s.RVALID && m.RREADY && s.RLAST)
+      complete(false, s.RID, m_cycle);
+    if (s.BVALID && m.BREADY)
+      complete(true, s.BID, m_cycle);
+
+    m_cycle++;
+  }
+}
+//-----------------------------------------------------------------
+// print_stats: Ranked breakdown to stdout
+//-----------------------------------------------------------------
+void tb_latency_attrib::print_stats(void) {
+  if (!enabled())
+    return;
+
+  printf("LATENCY: %llu / %llu bursts >= %d cycles (%llu cycles total)\n",
+         (unsigned long long)m_outliers, (unsigned long long)m_bursts,
+         m_threshold, (unsigned long long)m_latency);
+  if (!m_outliers)
+    return;
+
+  // Rank causes by cycles (insertion sort, stable)
+  int order[TB_LAT_MAX];
+  for (int i = 0; i < TB_LAT_MAX; i++) {
+    int j = i;
+    for (; j > 0 && m_cycles[order[j - 1]] < m_cycles[i]; j--)
+      order[j] = order[j - 1];
+    order[j] = i;
+  }
+
+  for (int i = 0; i < TB_LAT_MAX; i++) {
+    int c = order[i];
+    printf("LATENCY:   %-10s %10llu cycles (%5.1f%%), dominant in %llu\n",
+           cause_name(c), (unsigned long long)m_cycles[c],
+           (100.0 * m_cycles[c]) / m_latency,
+           (unsigned long long)m_dominant[c]);
+  }
+
+  if (m_truncated)
+    printf("LATENCY:   %llu bursts exceeded the %d cycle history\n",
+           (unsigned long long)m_truncated, TB_LAT_HISTORY);
+
+  for (size_t i = 0; i < m_details.size(); i++) {
+    const outlier &o = m_details[i];
+    printf("LATENCY:   %s ID %d 0x%08x x%d @ %llu: %llu cycles",
+           o.write ? "WR" : "RD", o.id, o.addr, o.len + 1,
+           (unsigned long long)o.cycle, (unsigned long long)o.latency);
+    for (int c = 0; c < TB_LAT_MAX; c++)
+      if (o.cycles[c])
+        printf(", %s %llu", cause_name(c), (unsigned long long)o.cycles[c]);
+    printf("\n");
+  }
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_latency_attrib::write_json(tb_json &js) {
+  js.value("threshold", m_threshold);
+  js.value("bursts", m_bursts);
+  js.value("outliers", m_outliers);
+  js.value("cycles", m_latency);
+
+  js.begin_object("causes");
+  for (int c = 0; c < TB_LAT_MAX; c++) {
+    js.begin_object(cause_name(c));
+    js.value("cycles", m_cycles[c]);
+    js.value("dominant", m_dominant[c]);
+    js.end_object();
+  }
+  js.end_object();
+}
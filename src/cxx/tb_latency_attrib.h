@@ -0,0 +1,116 @@
+#ifndef TB_LATENCY_ATTRIB_H
+#define TB_LATENCY_ATTRIB_H
+
+#include "axi4.h"
+#include "axi4_defines.h"
+#include "sdram_defines.h"
+#include "sdram_io.h"
+#include "tb_sdram_map.h"
+#include "tb_json.h"
+#include <deque>
+#include <vector>
+
+#define TB_LAT_HISTORY 4096    // Cycles of controller state kept
+#define TB_LAT_MAX_DETAILS 10  // Outliers printed individually
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_LAT_CAUSE {
+  TB_LAT_REFRESH,    // Owning core precharging / refreshing for refresh
+  TB_LAT_ROW_MISS,   // Precharge, activate, tRP / tRCD for a request
+  TB_LAT_TURNAROUND, // Core or front-end busy with the other direction
+  TB_LAT_ARB_LOSS,   // SdramAxiPmem granted the other direction
+  TB_LAT_OTHER_CHIP, // Ack ordering FIFO head is the other chip
+  TB_LAT_OTHER,      // Service time / queueing behind earlier bursts
+  TB_LAT_MAX
+};
+
+//-------------------------------------------------------------
+// tb_latency_attrib: Latency outlier attribution (passive)
+//   Keeps a short history of what each SdramCore and the AXI
+//   front-end were doing every cycle. When a burst completes
+//   with a latency of at least the threshold, each cycle of its
+//   AR (AW) to last R (B) interval is charged to one cause, in
+//   priority order, considering only the chip(s) the burst
+//   touches. Prints a ranked breakdown over all outliers.
+//-------------------------------------------------------------
+class tb_latency_attrib : public sc_module {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  sc_in<axi4_master> axi_m_in;
+  sc_in<axi4_slave> axi_s_in;
+
+  sc_in<sdram_core_debug> core_in[SDRAM_CHIPS];
+  sc_in<sdram_ctrl_debug> ctrl_in;
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_latency_attrib);
+  tb_latency_attrib(sc_module_name name);
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  // Attribute bursts taking >= cycles (0 = disabled)
+  void set_threshold(int cycles) { m_threshold = cycles; }
+  bool enabled(void) { return m_threshold > 0; }
+
+  static const char *cause_name(int cause);
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+protected:
+  void process(void);
+  uint32_t sample(void);
+  void complete(bool write, int id, uint64_t cycle);
+  int burst_chips(uint32_t addr, int len, int type);
+  int classify(uint32_t flags, bool write, int chips);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  struct burst {
+    uint64_t cycle;
+    uint32_t addr;
+    int len;
+    int chips; // Bit per chip touched
+  };
+
+  struct outlier {
+    bool write;
+    int id;
+    uint32_t addr;
+    int len;
+    uint64_t cycle;
+    uint64_t latency;
+    uint64_t cycles[TB_LAT_MAX];
+  };
+
+  int m_threshold;
+  uint64_t m_cycle;
+
+  // Controller state flags per cycle (ring)
+  uint32_t m_history[TB_LAT_HISTORY];
+
+  std::deque<burst> m_rd_pending[1 << AXI4_ID_W];
+  std::deque<burst> m_wr_pending[1 << AXI4_ID_W];
+
+  // Totals
+  uint64_t m_bursts;
+  uint64_t m_outliers;
+  uint64_t m_latency;
+  uint64_t m_truncated;
+  uint64_t m_cycles[TB_LAT_MAX];
+  uint64_t m_dominant[TB_LAT_MAX];
+  std::vector<outlier> m_details;
+};
+
+#endif
@@ -13,14 +13,14 @@ uint32_t tb_mem_test::get_mem_address(int space, int alignment) {
       num_regions++;
 
   do {
-    int i = rand() % num_regions;
+    int i = m_rand.below(num_regions);
 
     uint32_t base = m_mem[i]->get_base();
     uint32_t size = m_mem[i]->get_size();
 
     if (space < size) {
       size -= space;
-      addr = base + (rand() % size) & ~(alignment - 1);
+      addr = base + m_rand.below(size) & ~(alignment - 1);
       sc_assert(addr >= base);
       sc_assert((addr - base + space) < m_mem[i]->get_size());
       found = true;
@@ -31,26 +31,60 @@ uint32_t tb_mem_test::get_mem_address(int space, int alignment) {
   return addr;
 }
 //-----------------------------------------------------------------
+// pattern_access: Perform (and check) the next pattern access
+//-----------------------------------------------------------------
+void tb_mem_test::pattern_access(void) {
+  tb_access acc;
+  m_pattern->next(acc);
+
+  uint8_t *buffer = new uint8_t[acc.length];
+
+  if (acc.write) {
+    for (int i = 0; i < acc.length; i++) {
+      buffer[i] = m_rand.byte();
+      this->write(acc.addr + i, buffer[i]);
+    }
+
+    m_driver->write(acc.addr, buffer, acc.length);
+  } else {
+    m_driver->read(acc.addr, buffer, acc.length);
+
+    for (int i = 0; i < acc.length; i++) {
+      if (this->read(acc.addr + i) != buffer[i])
+        printf("MISMATCH: %08x -> %02x != %02x\n", acc.addr + i, buffer[i],
+               this->read(acc.addr + i));
+      sc_assert(this->read(acc.addr + i) == buffer[i]);
+    }
+  }
+
+  delete[] buffer; buffer = NULL;
+}
+//-----------------------------------------------------------------
 // process: Random reads and writes
 //-----------------------------------------------------------------
 void tb_mem_test::process(void) {
   while (true) {
     m_enabled.wait();
-    printf("Starting memory test sequence...\n");
+    if (m_pattern)
+      printf("Starting memory test sequence (%s)...\n", m_pattern->name());
+    else
+      printf("Starting memory test sequence...\n");
 
     int iterations = m_iterations.read();
 
-    while ((iterations == -1) || (iterations-- >= 1)) {
-      switch (rand() % 4) {
+    while (!m_stop && ((iterations == -1) || (iterations-- >= 1))) {
+      if (m_pattern) {
+        pattern_access();
+        continue;
+      }
+
+      switch (m_rand.below(4)) {
       // Word write
       case 0: {
         uint32_t addr = get_mem_address(4, 4);
 
         sc_uint<32> data;
-        data.range(31, 24) = rand();
-        data.range(23, 16) = rand();
-        data.range(15, 8) = rand();
-        data.range(7, 0) = rand();
+        data = m_rand.next();
 
         for (int i = 0; i < 4; i++)
           this->write(addr + i, (uint8_t)data.range((i * 8) + 7, (i * 8)));
@@ -79,7 +113,7 @@ void tb_mem_test::process(void) {
       } break;
       // Block read
       case 2: {
-        int length = 1 + (rand() % m_max_length);
+        int length = 1 + m_rand.below(m_max_length);
         uint32_t addr = get_mem_address(length, 1);
         uint8_t *buffer = new uint8_t[length];
 
@@ -96,12 +130,12 @@ void tb_mem_test::process(void) {
       } break;
       // Block write
       case 3: {
-        int length = 1 + (rand() % m_max_length);
+        int length = 1 + m_rand.below(m_max_length);
         uint32_t addr = get_mem_address(length, 1);
         uint8_t *buffer = new uint8_t[length];
 
         for (int i = 0; i < length; i++) {
-          buffer[i] = rand();
+          buffer[i] = m_rand.byte();
           this->write(addr + i, buffer[i]);
         }
 
@@ -3,6 +3,8 @@
 
 #include "tb_driver_api.h"
 #include "tb_memory.h"
+#include "tb_rand.h"
+#include "tb_traffic_pattern.h"
 #include <systemc.h>
 
 //-------------------------------------------------------------
@@ -26,16 +28,28 @@ public:
     SC_CTHREAD(process, clk_in.pos());
     m_driver = iface;
     m_max_length = max_length;
+    m_pattern = NULL;
+    m_stop = false;
+    m_rand.seed(1, this->name());
   }
 
   // API
   void start(int iterations = -1) {
     m_iterations = iterations;
+    m_stop = false;
     m_enabled.post();
   }
 
+  // End the current sequence early (after the access in progress)
+  void stop(void) { m_stop = true; }
+
   void wait_complete(void) { m_completed.wait(); }
 
+  void seed(uint32_t seed) { m_rand.seed(seed, this->name()); }
+
+  // Use a traffic pattern instead of the default random mix
+  void set_pattern(tb_traffic_pattern *pattern) { m_pattern = pattern; }
+
   void trace_access(bool en) {
     for (int i = 0; i < TB_MEM_MAX_REGIONS; i++)
       if (m_mem[i])
@@ -45,14 +59,18 @@ public:
   // Internal
 protected:
   uint32_t get_mem_address(int size, int alignment);
-  void process(void);
+  void pattern_access(void);
+  virtual void process(void);
 
 protected:
   sc_semaphore m_enabled;
   sc_semaphore m_completed;
   tb_driver_api *m_driver;
   sc_signal<int> m_iterations;
+  bool m_stop;
   int m_max_length;
+  tb_traffic_pattern *m_pattern;
+  tb_rand m_rand;
 };
 
 #endif
\ No newline at end of file
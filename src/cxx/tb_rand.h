@@ -0,0 +1,74 @@
+#ifndef TB_RAND_H
+#define TB_RAND_H
+
+#include <cstdint>
+
+//-------------------------------------------------------------
+// tb_rand: Small, fast PRNG (xoshiro128**) with named streams.
+//   Each component owns one and seeds it from the global --seed
+//   plus its own (hierarchical) name, so components draw from
+//   independent streams and adding draws in one component never
+//   shifts the random decisions of another.
+//-------------------------------------------------------------
+class tb_rand {
+public:
+  tb_rand(uint64_t seed = 1, const char *stream = "") {
+    this->seed(seed, stream);
+  }
+
+  void seed(uint64_t seed, const char *stream) {
+    // FNV-1a of the stream name, mixed into the seed
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const char *p = stream; p && *p; p++)
+      h = (h ^ (uint8_t)*p) * 0x100000001b3ULL;
+
+    uint64_t x = seed ^ h;
+    for (int i = 0; i < 4; i += 2) {
+      uint64_t z = splitmix64(x);
+      m_s[i] = (uint32_t)z;
+      m_s[i + 1] = (uint32_t)(z >> 32);
+    }
+
+    // All-zero state is the one invalid state
+    if (!(m_s[0] | m_s[1] | m_s[2] | m_s[3]))
+      m_s[0] = 1;
+  }
+
+  uint32_t next(void) {
+    uint32_t result = rotl(m_s[1] * 5, 7) * 9;
+    uint32_t t = m_s[1] << 9;
+
+    m_s[2] ^= m_s[0];
+    m_s[3] ^= m_s[1];
+    m_s[1] ^= m_s[2];
+    m_s[0] ^= m_s[3];
+    m_s[2] ^= t;
+    m_s[3] = rotl(m_s[3], 11);
+    return result;
+  }
+
+  // Uniform in [0, n) (multiply-shift, no division)
+  uint32_t below(uint32_t n) {
+    return (uint32_t)(((uint64_t)next() * n) >> 32);
+  }
+
+  bool bit(void) { return next() >> 31; }
+  uint8_t byte(void) { return next() >> 24; }
+
+  // True with probability pct / 100
+  bool percent(int pct) { return (int)below(100) < pct; }
+
+protected:
+  static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+  static uint64_t splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint32_t m_s[4];
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TB_SDRAM_MAP_H
+#define TB_SDRAM_MAP_H
+
+#include "sdram_defines.h"
+#include <cstdint>
+
+//-------------------------------------------------------------
+// tb_sdram_addr: Decoded SDRAM location of an AXI byte address
+//-------------------------------------------------------------
+struct tb_sdram_addr {
+  uint32_t chip;
+  uint32_t row;
+  uint32_t bank;
+  uint32_t col; // Word column within the row
+  uint32_t byte;
+};
+
+//-------------------------------------------------------------
+// tb_sdram_map: Mirror of the RTL address decode
+//   SdramInterleaveTop: chip = addr(CHIP_SEL_BIT), which is then
+//   squeezed out to form the core address.
+//   In lock-step (SDRAM_LANES 2) there is no chip bit: both chips
+//   hold every word, chip is 0.
+//   SdramCore: col = word index within the row, then bank and
+//   row fields in SDRAM_CORE_*_LSB order; with SDRAM_BANK_XOR the
+//   bank is the field XOR the low row bits.
+//   With bank | row | col, a region smaller than a bank only
+//   reaches bank 0 (encode() of other banks lands outside it).
+//-------------------------------------------------------------
+class tb_sdram_map {
+public:
+  static uint32_t core_addr(uint32_t addr) {
+    if (SDRAM_LANES > 1)
+      return addr;
+    uint32_t low = addr & ((1u << SDRAM_CHIP_SEL_BIT) - 1);
+    return ((addr >> (SDRAM_CHIP_SEL_BIT + 1)) << SDRAM_CHIP_SEL_BIT) | low;
+  }
+
+  static tb_sdram_addr decode(uint32_t addr) {
+    tb_sdram_addr a;
+    uint32_t core = core_addr(addr);
+
+    a.chip = 0;
+    if (SDRAM_LANES == 1)
+      a.chip = (addr >> SDRAM_CHIP_SEL_BIT) & (SDRAM_CHIPS - 1);
+    a.byte = core & (SDRAM_WORD_BYTES - 1);
+    a.col = (core >> SDRAM_CORE_COL_LSB) & ((1u << SDRAM_CORE_COL_W) - 1);
+    a.bank = (core >> SDRAM_CORE_BANK_LSB) & (SDRAM_BANKS - 1);
+    a.row = (core >> SDRAM_CORE_ROW_LSB) & (SDRAM_ROWS - 1);
+    a.bank ^= bank_hash(a.row);
+    return a;
+  }
+
+  static uint32_t encode(const tb_sdram_addr &a) {
+    uint32_t bank = (a.bank ^ bank_hash(a.row)) & (SDRAM_BANKS - 1);
+    uint32_t core = (a.row << SDRAM_CORE_ROW_LSB) |
+                    (bank << SDRAM_CORE_BANK_LSB) |
+                    (a.col << SDRAM_CORE_COL_LSB) |
+                    (a.byte & (SDRAM_WORD_BYTES - 1));
+    if (SDRAM_LANES > 1)
+      return core;
+    uint32_t low = core & ((1u << SDRAM_CHIP_SEL_BIT) - 1);
+
+    return ((core >> SDRAM_CHIP_SEL_BIT) << (SDRAM_CHIP_SEL_BIT + 1)) |
+           (a.chip << SDRAM_CHIP_SEL_BIT) | low;
+  }
+
+  static uint32_t encode(uint32_t chip, uint32_t row, uint32_t bank,
+                         uint32_t col) {
+    tb_sdram_addr a;
+    a.chip = chip;
+    a.row = row;
+    a.bank = bank;
+    a.col = col;
+    a.byte = 0;
+    return encode(a);
+  }
+
+  // Bytes of AXI space covered by one row index (all chips, and all
+  // banks unless bank | row | col)
+  static uint32_t row_span(void) {
+    return 1u << (SDRAM_CORE_ROW_LSB + (SDRAM_LANES > 1 ? 0 : 1));
+  }
+
+  // Words per row, per chip and bank
+  static uint32_t cols(void) { return 1u << SDRAM_CORE_COL_W; }
+
+  // Consecutive words on one chip before the next chip (lock-step:
+  // never changes)
+  static uint32_t chip_run(void) {
+#if SDRAM_LANES > 1
+    return cols();
+#else
+    return 1u << (SDRAM_CHIP_SEL_BIT - SDRAM_CORE_COL_LSB);
+#endif
+  }
+
+  // Chips touched by words consecutive words from addr (bit per chip)
+  static int chip_mask(uint32_t addr, int words) {
+    if (SDRAM_LANES > 1)
+      return (1 << SDRAM_CHIPS) - 1;
+    int mask = 0;
+    for (int i = 0; i < words && mask != (1 << SDRAM_CHIPS) - 1; i++)
+      mask |= 1 << decode(addr + i * SDRAM_WORD_BYTES).chip;
+    return mask;
+  }
+
+protected:
+  // SdramParams.bankXor: bank bits XOR the low row bits
+  static uint32_t bank_hash(uint32_t row) {
+    return SDRAM_BANK_XOR ? (row & (SDRAM_BANKS - 1)) : 0;
+  }
+};
+
+#endif
@@ -0,0 +1,424 @@
+#include "tb_sdram_model.h"
+#include "tb_traffic_pattern.h"
+#include <string.h>
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_sdram_model::tb_sdram_model() {
+  m_params.mhz = SDRAM_MHZ;
+  m_params.cas_latency = SDRAM_CAS_LATENCY;
+  m_params.trcd_ns = SDRAM_TRCD_NS;
+  m_params.trp_ns = SDRAM_TRP_NS;
+  m_params.trfc_ns = SDRAM_TRFC_NS;
+  m_params.refresh_cycles = (64000 * SDRAM_MHZ) / SDRAM_ROWS - 1;
+  m_params.chips = SDRAM_CHIPS;
+  m_params.data_w = SDRAM_DATA_W;
+  m_params.ar_queue_depth = SDRAM_PMEM_AR_DEPTH;
+  m_params.aw_queue_depth = SDRAM_PMEM_AW_DEPTH;
+  m_params.read_depth = SDRAM_PMEM_READ_DEPTH;
+  m_params.rw_batch = SDRAM_PMEM_RW_BATCH;
+  m_params.core_queue_depth = SDRAM_CORE_QUEUE_DEPTH;
+  m_params.stream_depth = SDRAM_STREAM_DEPTH;
+
+  // Until described otherwise: long sequential reads
+  m_traffic.name = "default";
+  m_traffic.beats = 8;
+  m_traffic.write_pct = 0;
+  m_traffic.row_miss = 0;
+  m_traffic.row_open = 0;
+  m_traffic.row_exposed = 1.0 / SDRAM_BANKS;
+  m_traffic.chips = stream_chips();
+}
+//-----------------------------------------------------------------
+// set_value: Apply one config entry
+//-----------------------------------------------------------------
+bool tb_sdram_model::set_value(const char *key, const char *value) {
+  int i = strtol(value, NULL, 0);
+  double v = strtod(value, NULL);
+
+  if (!strcasecmp(key, "mhz") && i > 0)
+    m_params.mhz = i;
+  else if (!strcasecmp(key, "cas_latency"))
+    m_params.cas_latency = i;
+  else if (!strcasecmp(key, "trcd_ns"))
+    m_params.trcd_ns = i;
+  else if (!strcasecmp(key, "trp_ns"))
+    m_params.trp_ns = i;
+  else if (!strcasecmp(key, "trfc_ns"))
+    m_params.trfc_ns = i;
+  else if (!strcasecmp(key, "refresh_cycles"))
+    m_params.refresh_cycles = i;
+  else if (!strcasecmp(key, "chips") && i > 0)
+    m_params.chips = i;
+  else if (!strcasecmp(key, "ar_queue_depth"))
+    m_params.ar_queue_depth = i;
+  else if (!strcasecmp(key, "aw_queue_depth"))
+    m_params.aw_queue_depth = i;
+  else if (!strcasecmp(key, "read_depth") && i > 0)
+    m_params.read_depth = i;
+  else if (!strcasecmp(key, "rw_batch"))
+    m_params.rw_batch = i;
+  else if (!strcasecmp(key, "core_queue_depth"))
+    m_params.core_queue_depth = i;
+  else if (!strcasecmp(key, "stream_depth"))
+    m_params.stream_depth = i;
+  else if (!strcasecmp(key, "beats") && v >= 1)
+    m_traffic.beats = v;
+  else if (!strcasecmp(key, "write_pct"))
+    m_traffic.write_pct = i;
+  else if (!strcasecmp(key, "row_miss"))
+    m_traffic.row_miss = v;
+  else if (!strcasecmp(key, "row_open"))
+    m_traffic.row_open = v;
+  else if (!strcasecmp(key, "row_exposed"))
+    m_traffic.row_exposed = v;
+  else
+    return false;
+
+  return true;
+}
+//-----------------------------------------------------------------
+// load: Read params / traffic overrides (missing keys keep theirs)
+//-----------------------------------------------------------------
+bool tb_sdram_model::load(const char *filename) {
+  FILE *f = fopen(filename, "r");
+  if (!f) {
+    printf("ERROR: Could not open %s\n", filename);
+    return false;
+  }
+
+  char line[256];
+  int line_no = 0;
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), f)) {
+    line_no++;
+
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = 0;
+    char *eq = strchr(line, '=');
+    if (eq)
+      *eq = ' ';
+
+    char key[32], value[64];
+    int n = sscanf(line, "%31s %63s", key, value);
+    if (n <= 0)
+      continue;
+
+    if (n < 2 || !set_value(key, value)) {
+      printf("ERROR: %s:%d: Expected 'key value' (mhz, cas_latency, "
+             "trcd_ns, trp_ns, trfc_ns, refresh_cycles, chips, "
+             "ar_queue_depth, aw_queue_depth, read_depth, rw_batch, "
+             "core_queue_depth, stream_depth, beats, write_pct, row_miss, "
+             "row_open, row_exposed)\n",
+             filename, line_no);
+      ok = false;
+    }
+  }
+
+  fclose(f);
+  m_traffic.name += " (";
+  m_traffic.name += filename;
+  m_traffic.name += ")";
+  return ok;
+}
+//-----------------------------------------------------------------
+// set_pattern: Beats and row behaviour of a tb_traffic_pattern
+//-----------------------------------------------------------------
+void tb_sdram_model::set_pattern(int type, int max_length, uint32_t stride,
+                                 int write_pct) {
+  m_traffic.name = tb_traffic_pattern::type_name(type);
+  m_traffic.write_pct = write_pct;
+  m_traffic.beats = 1;
+  m_traffic.row_miss = 1;
+  m_traffic.row_open = 0;
+  m_traffic.row_exposed = 1.0 / SDRAM_BANKS;
+  m_traffic.chips = stream_chips();
+
+  switch (type) {
+  case TB_PATTERN_RANDOM:
+    // Half single words, half 1..max_length bytes unaligned
+    m_traffic.beats = 0.5 + 0.5 * ((max_length + 1) / (2.0 * AXI4_STRB_W) + 1);
+    break;
+  case TB_PATTERN_SEQUENTIAL:
+    m_traffic.beats = max_length / AXI4_STRB_W;
+    walk_rows(max_length, max_length / AXI4_STRB_W);
+    break;
+  case TB_PATTERN_STRIDE:
+    walk_rows(stride < 4 ? 4 : stride & ~3, 1);
+    break;
+  case TB_PATTERN_BANK_ROUND_ROBIN:
+    m_traffic.row_miss = 0;
+    break;
+  case TB_PATTERN_ROW_THRASH:
+    // Always chip 0, bank 0
+    m_traffic.row_exposed = 1;
+    break;
+  case TB_PATTERN_CHIP_HOTSPOT:
+  default:
+    break;
+  }
+
+  if (m_traffic.beats < 1)
+    m_traffic.beats = 1;
+}
+//-----------------------------------------------------------------
+// walk_rows: Row behaviour of a linear walk through the address map
+//   Bursts of words words, step bytes apart. Counts row misses /
+//   closed bank activates per burst over the second half of the
+//   walk (the first opens the rows), and how many of them fall on
+//   the bank the chip's previous word used.
+//-----------------------------------------------------------------
+void tb_sdram_model::walk_rows(uint32_t step, int words) {
+  const int bursts = 8192;
+  int open_row[SDRAM_CHIPS][SDRAM_BANKS];
+  int last_bank[SDRAM_CHIPS];
+  double miss = 0, opens = 0, exposed = 0;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    last_bank[c] = -1;
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      open_row[c][b] = -1;
+  }
+
+  for (int i = 0; i < bursts; i++) {
+    bool count = i >= bursts / 2;
+    for (int w = 0; w < words; w++) {
+      tb_sdram_addr a = tb_sdram_map::decode(i * step + w * AXI4_STRB_W);
+      int &row = open_row[a.chip][a.bank];
+      if (row != (int)a.row && count) {
+        if (row < 0)
+          opens++;
+        else
+          miss++;
+        if (last_bank[a.chip] == (int)a.bank)
+          exposed++;
+      }
+      row = a.row;
+      last_bank[a.chip] = a.bank;
+    }
+  }
+
+  m_traffic.row_miss = miss / (bursts / 2);
+  m_traffic.row_open = opens / (bursts / 2);
+  if (miss + opens > 0)
+    m_traffic.row_exposed = exposed / (miss + opens);
+}
+//-----------------------------------------------------------------
+// stream_chips: Chips a multi-word burst keeps busy at once
+//-----------------------------------------------------------------
+int tb_sdram_model::stream_chips(void) {
+  // Lock-step: the chips are one device
+  if (SDRAM_LANES > 1)
+    return 1;
+
+  // The front-end issues in address order; the other chip only gets
+  // work while this one still holds a run in its stream and queue
+  int queue = m_params.core_queue_depth < 1 ? 1 : m_params.core_queue_depth;
+  queue += m_params.stream_depth;
+  return (int)tb_sdram_map::chip_run() <= queue ? SDRAM_CHIPS : 1;
+}
+//-----------------------------------------------------------------
+// word_period: Cycles between accepts within a burst
+//-----------------------------------------------------------------
+double tb_sdram_model::word_period(int chips) {
+  // A chip moves one word every 2 cycles; one request per cycle
+  double period = 2.0 / chips;
+  return period < 1 ? 1 : period;
+}
+//-----------------------------------------------------------------
+// read_word_period: word_period, bounded by the reads in flight
+//-----------------------------------------------------------------
+double tb_sdram_model::read_word_period(int chips) {
+  // Each word holds a slot from grant to R (AR -> R less the AR), plus
+  // the cycle after R before the slot frees
+  double period = read_latency_hit() / (double)m_params.read_depth;
+  double device = word_period(chips);
+  return period > device ? period : device;
+}
+//-----------------------------------------------------------------
+// read_burst_cycles: Cycles per read burst (all row hits)
+//-----------------------------------------------------------------
+double tb_sdram_model::read_burst_cycles(double beats) {
+  // Queued: bursts issue back-to-back, alternating chips throughout
+  if (m_params.ar_queue_depth > 0)
+    return beats * read_word_period(m_traffic.chips);
+
+  // One at a time: AR accept to next AR accept
+  int chips = beats > 1 ? m_traffic.chips : 1;
+  return read_latency_hit() + 1 + (beats - 1) * read_word_period(chips);
+}
+//-----------------------------------------------------------------
+// write_burst_cycles: AW accept to next AW accept (all row hits)
+//-----------------------------------------------------------------
+double tb_sdram_model::write_burst_cycles(double beats) {
+  // Queued: the next burst's requests follow straight on
+  if (m_params.aw_queue_depth > 0)
+    return beats * word_period(m_traffic.chips);
+
+  int chips = beats > 1 ? m_traffic.chips : 1;
+  return 8 + (beats - 1) * word_period(chips);
+}
+//-----------------------------------------------------------------
+// turnaround_cycles: Mean read / write switch cost per burst
+//-----------------------------------------------------------------
+double tb_sdram_model::turnaround_cycles(double beats) {
+  // Unqueued bursts already pay their full latency each
+  if (m_params.ar_queue_depth == 0 || m_params.aw_queue_depth == 0)
+    return 0;
+
+  // Bursts of random direction switch 2w(1 - w) of the time,
+  // divided by the bursts grouped into one run
+  double w = m_traffic.write_pct / 100.0;
+  double group = 1;
+  if (m_params.rw_batch > 0) {
+    int queued = m_params.ar_queue_depth < m_params.aw_queue_depth
+                     ? m_params.ar_queue_depth
+                     : m_params.aw_queue_depth;
+    double batch = m_params.rw_batch / beats;
+    group = queued + 1.0 < batch ? queued + 1.0 : batch;
+    if (group < 1)
+      group = 1;
+  }
+
+  // Old direction's acks drain: CL + 3 after a read, 2 after a write
+  double drain = (m_params.cas_latency + 3 + 2) / 2.0;
+  return 2 * w * (1 - w) / group * drain;
+}
+//-----------------------------------------------------------------
+// refresh_derate: Fraction of cycles left after refresh
+//-----------------------------------------------------------------
+double tb_sdram_model::refresh_derate(void) {
+  // Both cores leave init together, so the chips refresh in step
+  double interval = m_params.refresh_cycles + 1;
+  double cost = 1 + m_params.cycles(m_params.trp_ns) + 1 +
+                m_params.cycles(m_params.trfc_ns) + 1 + 1 +
+                m_params.cycles(m_params.trcd_ns);
+  if (cost >= interval)
+    return 0;
+  return (interval - cost) / interval;
+}
+//-----------------------------------------------------------------
+// device_peak_bw: Every chip transferring every cycle
+//-----------------------------------------------------------------
+double tb_sdram_model::device_peak_bw(void) {
+  return m_params.chips * m_params.data_w / 8.0;
+}
+//-----------------------------------------------------------------
+// controller_peak_bw: Endless row hit read stream, no refresh
+//-----------------------------------------------------------------
+double tb_sdram_model::controller_peak_bw(void) {
+  return (double)AXI4_STRB_W / read_word_period(m_traffic.chips);
+}
+//-----------------------------------------------------------------
+// sustained_bw: Predicted for the described traffic
+//-----------------------------------------------------------------
+double tb_sdram_model::sustained_bw(void) {
+  double w = m_traffic.write_pct / 100.0;
+  double beats = m_traffic.beats;
+  int trcd = m_params.cycles(m_params.trcd_ns);
+  int trp = m_params.cycles(m_params.trp_ns);
+
+  // Rows of queued requests on other banks open in the background
+  double exposed = 1;
+  if (m_params.core_queue_depth > 1)
+    exposed = m_traffic.row_exposed;
+
+  double cycles = (1 - w) * read_burst_cycles(beats) +
+                  w * write_burst_cycles(beats) + turnaround_cycles(beats) +
+                  exposed * (m_traffic.row_miss * (1 + trp + trcd) +
+                             m_traffic.row_open * trcd);
+
+  return AXI4_STRB_W * beats / cycles * refresh_derate();
+}
+//-----------------------------------------------------------------
+// read_latency_hit: AR handshake to R handshake, one beat
+//-----------------------------------------------------------------
+int tb_sdram_model::read_latency_hit(void) {
+  // AR -> rBurst -> core idle -> READ (accept) -> CL + 2 sample
+  // shift -> ack -> rDataQ -> R
+  return m_params.cas_latency + 6;
+}
+//-----------------------------------------------------------------
+// read_latency_closed: Plus tRCD (ACT issued while idle)
+//-----------------------------------------------------------------
+int tb_sdram_model::read_latency_closed(void) {
+  return read_latency_hit() + m_params.cycles(m_params.trcd_ns);
+}
+//-----------------------------------------------------------------
+// read_latency_miss: Plus precharge + tRP
+//-----------------------------------------------------------------
+int tb_sdram_model::read_latency_miss(void) {
+  return read_latency_closed() + 1 + m_params.cycles(m_params.trp_ns);
+}
+//-----------------------------------------------------------------
+// write_latency_hit: AW handshake to B handshake, one beat
+//-----------------------------------------------------------------
+int tb_sdram_model::write_latency_hit(void) {
+  // AW -> load -> core idle -> WRITE0 (accept) -> ack 2 later -> B
+  return 7;
+}
+//-----------------------------------------------------------------
+// print_stats: Prediction next to the measured results
+//-----------------------------------------------------------------
+void tb_sdram_model::print_stats(tb_axi4_monitor *mon) {
+  double mhz = m_params.mhz;
+  double device = device_peak_bw();
+  double peak = controller_peak_bw();
+  double model = sustained_bw();
+  double measured = mon->read_bw() + mon->write_bw();
+
+  printf("MODEL: %s: %.1f beats/burst, %d%% writes, %.3f row misses "
+         "+ %.3f activates/burst (%.0f%% same bank), %d chip(s)\n",
+         m_traffic.name.c_str(), m_traffic.beats, m_traffic.write_pct,
+         m_traffic.row_miss, m_traffic.row_open,
+         100.0 * m_traffic.row_exposed, m_traffic.chips);
+  printf("MODEL: device peak     %.2f B/cycle (%.1f MB/s)\n", device,
+         device * mhz);
+  printf("MODEL: controller peak %.2f B/cycle (%.1f MB/s), %.1f%% of "
+         "device\n",
+         peak, peak * mhz, (100.0 * peak) / device);
+  printf("MODEL: sustained       %.2f B/cycle (%.1f MB/s) predicted, "
+         "%.2f B/cycle (%.1f MB/s) measured\n",
+         model, model * mhz, measured, measured * mhz);
+  printf("MODEL: efficiency      %.1f%% of model, %.1f%% of controller "
+         "peak, %.1f%% of device peak\n",
+         model > 0 ? (100.0 * measured) / model : 0.0,
+         (100.0 * measured) / peak, (100.0 * measured) / device);
+  printf("MODEL: read latency    hit %d / closed %d / miss %d cycles "
+         "predicted, min %llu measured\n",
+         read_latency_hit(), read_latency_closed(), read_latency_miss(),
+         (unsigned long long)mon->read_latency().percentile(0));
+  printf("MODEL: write latency   hit %d cycles predicted, min %llu "
+         "measured\n",
+         write_latency_hit(),
+         (unsigned long long)mon->write_latency().percentile(0));
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_sdram_model::write_json(tb_json &js, tb_axi4_monitor *mon) {
+  double model = sustained_bw();
+  double measured = mon->read_bw() + mon->write_bw();
+
+  js.begin_object("traffic");
+  js.value("name", m_traffic.name.c_str());
+  js.value("beats", m_traffic.beats);
+  js.value("write_pct", m_traffic.write_pct);
+  js.value("row_miss", m_traffic.row_miss);
+  js.value("row_open", m_traffic.row_open);
+  js.value("row_exposed", m_traffic.row_exposed);
+  js.end_object();
+
+  js.value("device_peak_bpc", device_peak_bw());
+  js.value("controller_peak_bpc", controller_peak_bw());
+  js.value("sustained_bpc", model);
+  js.value("measured_bpc", measured);
+  js.value("efficiency_pct", model > 0 ? (100.0 * measured) / model : 0.0);
+  js.value("read_latency_hit", read_latency_hit());
+  js.value("read_latency_closed", read_latency_closed());
+  js.value("read_latency_miss", read_latency_miss());
+  js.value("write_latency_hit", write_latency_hit());
+}
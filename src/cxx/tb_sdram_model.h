@@ -0,0 +1,134 @@
+#ifndef TB_SDRAM_MODEL_H
+#define TB_SDRAM_MODEL_H
+
+#include "sdram_defines.h"
+#include "tb_axi4_monitor.h"
+#include "tb_json.h"
+#include <string>
+
+//-------------------------------------------------------------
+// tb_sdram_model_params: SdramParams subset the model needs
+//-------------------------------------------------------------
+struct tb_sdram_model_params {
+  int mhz;
+  int cas_latency;
+  int trcd_ns;
+  int trp_ns;
+  int trfc_ns;
+  int refresh_cycles; // SdramParams.refreshCycles (REF every N+1)
+  int chips;
+  int data_w;
+  int ar_queue_depth;   // SdramParams.arQueueDepth
+  int aw_queue_depth;   // SdramParams.awQueueDepth
+  int read_depth;       // SdramParams.readDepth (read words in flight)
+  int rw_batch;         // SdramParams.rwBatch
+  int core_queue_depth; // SdramParams.coreQueueDepth
+  int stream_depth;     // SdramParams.streamDepth
+
+  // As SdramParams.cycles
+  int cycles(int ns) const { return (ns * mhz + 999) / 1000; }
+};
+
+//-------------------------------------------------------------
+// tb_sdram_model_traffic: Traffic pattern description
+//-------------------------------------------------------------
+struct tb_sdram_model_traffic {
+  std::string name;
+  double beats;    // Mean AXI beats (AXI4_DATA_W) per burst
+  int write_pct;   // Bursts that are writes
+  double row_miss;    // Row conflicts (precharge + activate) per burst
+  double row_open;    // Closed bank activates per burst
+  double row_exposed; // Share of those on the previous request's bank
+  int chips;          // Chips a multi-beat burst alternates over
+};
+
+//-------------------------------------------------------------
+// tb_sdram_model: Analytical bandwidth / latency model
+//   Closed form cycle counts for SdramAxiPmem + SdramCore:
+//   - The pmem presents one request per cycle into the target
+//     chip's request stream, so a burst is issued word by word
+//     and both chips drain their streams in parallel. A chip
+//     keeps its row open after a RD / WR (read_burst /
+//     write_burst) and takes a row hit every 2 cycles, from the
+//     running BL burst or with a new command, so the chips
+//     stream together: max(1, 2 / chips) cycles per word. In
+//     lock-step (SDRAM_LANES 2) the chips are one device moving
+//     a 64-bit word every 2 cycles.
+//   - Read:  AR -> last R = CL + 6 + (n - 1) x word period
+//     Write: AW -> B      = 5 + (n - 1) x word period + 2
+//     and the next address is accepted one cycle later. With an
+//     AR (AW) queue the next burst issues straight after the
+//     last request of the current one (n x word period).
+//   - Reads in flight are capped at readDepth words, each held
+//     from grant to R (CL + 5) plus the cycle before its slot
+//     frees, so a read word takes at least (CL + 6) / readDepth
+//     cycles.
+//   - With both queues, mixed traffic pays the ack drain of the
+//     old direction on each read / write switch; the scheduler
+//     groups up to rwBatch requests (bounded by what is queued)
+//     per switch.
+//   - Row conflicts add precharge + tRP + activate + tRCD, closed
+//     banks tRCD, per occurrence. The bank scheduler issues ACT /
+//     PRE in idle command slots; with a core queue the next
+//     request's row opens under the current one unless both are
+//     on the same bank (row_exposed: 1 / banks for random
+//     traffic; linear patterns walk the address map).
+//   - A burst alternates chips when a chip's run of consecutive
+//     words (chip interleave granularity) fits its request stream
+//     plus core queue.
+//   - Refresh steals precharge + tRP + REF + tRFC + idle, plus
+//     one re-activate, every refreshCycles + 1 cycles.
+//
+//   Config file: 'key value' per line, '#' comments. Keys: mhz,
+//   cas_latency, trcd_ns, trp_ns, trfc_ns, refresh_cycles, chips,
+//   ar_queue_depth, aw_queue_depth, read_depth, rw_batch,
+//   core_queue_depth, stream_depth, and traffic: beats, write_pct, row_miss,
+//   row_open, row_exposed.
+//-------------------------------------------------------------
+class tb_sdram_model {
+public:
+  tb_sdram_model();
+
+  bool load(const char *filename);
+
+  // Describe the traffic of a tb_traffic_pattern (--testcase)
+  void set_pattern(int type, int max_length, uint32_t stride,
+                   int write_pct);
+
+  const tb_sdram_model_params &params(void) { return m_params; }
+  const tb_sdram_model_traffic &traffic(void) { return m_traffic; }
+
+  // Bytes per clock cycle
+  double device_peak_bw(void);
+  double controller_peak_bw(void);
+  double sustained_bw(void);
+
+  // Clock cycles, one burst of one beat on an idle controller
+  int read_latency_hit(void);
+  int read_latency_closed(void);
+  int read_latency_miss(void);
+  int write_latency_hit(void);
+
+  // Prediction next to what the monitor measured
+  void print_stats(tb_axi4_monitor *mon);
+  void write_json(tb_json &js, tb_axi4_monitor *mon);
+
+protected:
+  bool set_value(const char *key, const char *value);
+  void walk_rows(uint32_t step, int words);
+  int stream_chips(void);
+  double word_period(int chips);
+  double read_word_period(int chips);
+  double read_burst_cycles(double beats);
+  double write_burst_cycles(double beats);
+  double turnaround_cycles(double beats);
+  double refresh_derate(void);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  tb_sdram_model_params m_params;
+  tb_sdram_model_traffic m_traffic;
+};
+
+#endif
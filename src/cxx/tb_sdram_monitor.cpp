@@ -0,0 +1,198 @@
+#include "tb_sdram_monitor.h"
+#include "tb_sim_profile.h"
+
+//-----------------------------------------------------------------
+// reset_stats: Clear counters (bank state is kept)
+//-----------------------------------------------------------------
+void tb_sdram_monitor::reset_stats(void) {
+  m_cycles = 0;
+  m_data_cycles = 0;
+  m_idle_cycles = 0;
+  m_turnarounds = 0;
+  m_reopens = 0;
+
+  for (int c = 0; c < SDRAM_CMD_MAX; c++) {
+    m_cmd[c] = 0;
+    for (int b = 0; b < SDRAM_BANKS; b++)
+      m_bank_cmd[b][c] = 0;
+  }
+
+  for (int b = 0; b < SDRAM_BANKS; b++) {
+    m_row_hits[b] = 0;
+    m_row_misses[b] = 0;
+  }
+}
+//-----------------------------------------------------------------
+// row_hits: Row hits over all banks
+//-----------------------------------------------------------------
+uint64_t tb_sdram_monitor::row_hits(void) {
+  uint64_t total = 0;
+  for (int b = 0; b < SDRAM_BANKS; b++)
+    total += m_row_hits[b];
+  return total;
+}
+//-----------------------------------------------------------------
+// row_misses: Row misses over all banks
+//-----------------------------------------------------------------
+uint64_t tb_sdram_monitor::row_misses(void) {
+  uint64_t total = 0;
+  for (int b = 0; b < SDRAM_BANKS; b++)
+    total += m_row_misses[b];
+  return total;
+}
+//-----------------------------------------------------------------
+// row_hit_rate: Fraction of RD / WR that needed no ACT
+//-----------------------------------------------------------------
+double tb_sdram_monitor::row_hit_rate(void) {
+  uint64_t hits = row_hits();
+  uint64_t total = hits + row_misses();
+  return total ? (double)hits / total : 0.0;
+}
+//-----------------------------------------------------------------
+// process: Decode the command bus every clock
+//-----------------------------------------------------------------
+void tb_sdram_monitor::process(void) {
+  const uint64_t burst_mask = (1ULL << SDRAM_BURST_LEN) - 1;
+
+  while (true) {
+    wait();
+    m_cycle++;
+    tb_prof_scope prof(TB_PROF_TESTBENCH);
+
+    if (rst_in.read())
+      continue;
+
+    sdram_io io = sdram_in.read();
+    int cmd = io.command();
+    int bank = (int)io.BA;
+    bool all_banks = (io.ADDR >> SDRAM_AUTO_PRECHARGE_BIT) & 1;
+    int shift;
+
+    switch (cmd) {
+    case SDRAM_CMD_ACTIVE:
+      m_fresh[bank] = true;
+      if (m_enabled && m_closed_row[bank] == (int)io.ADDR)
+        m_reopens++;
+      m_open_row[bank] = (int)io.ADDR;
+      m_closed_row[bank] = -1;
+      break;
+    case SDRAM_CMD_PRECHARGE:
+      // PRE all (refresh) is not a page policy decision
+      for (int b = 0; b < SDRAM_BANKS; b++)
+        if (all_banks || b == bank) {
+          m_closed_row[b] = all_banks ? -1 : m_open_row[b];
+          m_open_row[b] = -1;
+        }
+      break;
+    case SDRAM_CMD_READ:
+    case SDRAM_CMD_WRITE:
+      if (m_enabled) {
+        if (m_fresh[bank])
+          m_row_misses[bank]++;
+        else
+          m_row_hits[bank]++;
+      }
+      m_fresh[bank] = false;
+
+      if (m_enabled && m_last_dir != SDRAM_CMD_NOP && m_last_dir != cmd)
+        m_turnarounds++;
+      m_last_dir = cmd;
+
+      // Read data appears CAS latency later, write data is immediate;
+      // the rest of an earlier burst is cut off
+      shift = (cmd == SDRAM_CMD_READ) ? SDRAM_CAS_LATENCY : 0;
+      m_data_busy &= (1ULL << shift) - 1;
+      m_data_busy |= burst_mask << shift;
+      break;
+    case SDRAM_CMD_TERMINATE:
+      // Read data stops CAS latency later, write data immediately
+      shift = (m_last_dir == SDRAM_CMD_READ) ? SDRAM_CAS_LATENCY : 0;
+      m_data_busy &= (1ULL << shift) - 1;
+      break;
+    default:
+      break;
+    }
+
+    bool data_busy = m_data_busy & 1;
+    m_data_busy >>= 1;
+
+    for (size_t i = 0; i < m_observers.size(); i++)
+      m_observers[i]->sdram_cycle(m_chip, m_cycle, cmd, io);
+
+    if (!m_enabled)
+      continue;
+
+    m_cycles++;
+    m_cmd[cmd]++;
+
+    // PRE all is only counted per chip
+    if (cmd == SDRAM_CMD_ACTIVE || cmd == SDRAM_CMD_READ ||
+        cmd == SDRAM_CMD_WRITE ||
+        (cmd == SDRAM_CMD_PRECHARGE && !all_banks))
+      m_bank_cmd[bank][cmd]++;
+
+    if (data_busy)
+      m_data_cycles++;
+    else if (cmd == SDRAM_CMD_NOP)
+      m_idle_cycles++;
+  }
+}
+//-----------------------------------------------------------------
+// print_stats: Summary to stdout
+//-----------------------------------------------------------------
+void tb_sdram_monitor::print_stats(void) {
+  printf("SDRAM%d: %llu cycles:", m_chip, (unsigned long long)m_cycles);
+  for (int c = SDRAM_CMD_ACTIVE; c < SDRAM_CMD_MAX; c++)
+    printf(" %s %llu", sdram_io::command_name(c),
+           (unsigned long long)m_cmd[c]);
+  printf("\n");
+
+  for (int b = 0; b < SDRAM_BANKS; b++)
+    printf("SDRAM%d: bank %d: ACT %llu RD %llu WR %llu PRE %llu, "
+           "row hits %llu misses %llu\n",
+           m_chip, b, (unsigned long long)m_bank_cmd[b][SDRAM_CMD_ACTIVE],
+           (unsigned long long)m_bank_cmd[b][SDRAM_CMD_READ],
+           (unsigned long long)m_bank_cmd[b][SDRAM_CMD_WRITE],
+           (unsigned long long)m_bank_cmd[b][SDRAM_CMD_PRECHARGE],
+           (unsigned long long)m_row_hits[b],
+           (unsigned long long)m_row_misses[b]);
+
+  printf("SDRAM%d: row hit rate %.1f%%, data bus utilization %.1f%%, "
+         "idle %llu cycles, %llu RD/WR turnarounds, %llu reopens\n",
+         m_chip, row_hit_rate() * 100.0, data_utilization() * 100.0,
+         (unsigned long long)m_idle_cycles,
+         (unsigned long long)m_turnarounds, (unsigned long long)m_reopens);
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_sdram_monitor::write_json(tb_json &js) {
+  js.value("chip", m_chip);
+  js.value("cycles", m_cycles);
+
+  js.begin_object("commands");
+  for (int c = SDRAM_CMD_ACTIVE; c < SDRAM_CMD_MAX; c++)
+    js.value(sdram_io::command_name(c), m_cmd[c]);
+  js.end_object();
+
+  js.begin_array("banks");
+  for (int b = 0; b < SDRAM_BANKS; b++) {
+    js.begin_object();
+    js.value("bank", b);
+    js.value("ACT", m_bank_cmd[b][SDRAM_CMD_ACTIVE]);
+    js.value("RD", m_bank_cmd[b][SDRAM_CMD_READ]);
+    js.value("WR", m_bank_cmd[b][SDRAM_CMD_WRITE]);
+    js.value("PRE", m_bank_cmd[b][SDRAM_CMD_PRECHARGE]);
+    js.value("row_hits", m_row_hits[b]);
+    js.value("row_misses", m_row_misses[b]);
+    js.end_object();
+  }
+  js.end_array();
+
+  js.value("row_hit_rate", row_hit_rate());
+  js.value("data_bus_utilization", data_utilization());
+  js.value("data_cycles", m_data_cycles);
+  js.value("idle_cycles", m_idle_cycles);
+  js.value("turnarounds", m_turnarounds);
+  js.value("reopens", m_reopens);
+}
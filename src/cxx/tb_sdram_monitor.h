@@ -0,0 +1,129 @@
+#ifndef TB_SDRAM_MONITOR_H
+#define TB_SDRAM_MONITOR_H
+
+#include "sdram_defines.h"
+#include "sdram_io.h"
+#include "tb_json.h"
+#include <vector>
+
+//-------------------------------------------------------------
+// tb_sdram_observer: Per-cycle hook on a chip's command bus
+//-------------------------------------------------------------
+class tb_sdram_observer {
+public:
+  virtual ~tb_sdram_observer() {}
+
+  // Called every (non reset) clock with the decoded command
+  virtual void sdram_cycle(int chip, uint64_t cycle, int cmd,
+                           const sdram_io &io) = 0;
+};
+
+//-------------------------------------------------------------
+// tb_sdram_monitor: Passive SDRAM command bus monitor (one chip)
+//   Counts commands per bank, classifies each RD / WR as a row
+//   hit (row already open and accessed) or miss (first access
+//   after ACT), tracks data bus occupancy from the burst
+//   length and CAS latency, and counts read / write turnarounds
+//   (RD after WR or WR after RD) and reopens (ACT of the row a
+//   single bank PRE just closed: the page policy closed early).
+//-------------------------------------------------------------
+class tb_sdram_monitor : public sc_module {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  sc_in<sdram_io> sdram_in;
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_sdram_monitor);
+  tb_sdram_monitor(sc_module_name name, int chip) : sc_module(name) {
+    SC_CTHREAD(process, clk_in.pos());
+    m_chip = chip;
+    m_cycle = 0;
+    m_enabled = true;
+    m_data_busy = 0;
+    m_last_dir = SDRAM_CMD_NOP;
+    for (int b = 0; b < SDRAM_BANKS; b++) {
+      m_fresh[b] = false;
+      m_open_row[b] = -1;
+      m_closed_row[b] = -1;
+    }
+    reset_stats();
+  }
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  void add_observer(tb_sdram_observer *obs) { m_observers.push_back(obs); }
+
+  // Measurement window (enabled from construction)
+  void start(void) {
+    reset_stats();
+    m_enabled = true;
+  }
+  void stop(void) { m_enabled = false; }
+
+  int chip(void) { return m_chip; }
+  uint64_t cycle(void) { return m_cycle; }
+  uint64_t cycles(void) { return m_cycles; }
+  uint64_t commands(int cmd) { return m_cmd[cmd]; }
+  uint64_t commands(int cmd, int bank) { return m_bank_cmd[bank][cmd]; }
+  uint64_t row_hits(int bank) { return m_row_hits[bank]; }
+  uint64_t row_misses(int bank) { return m_row_misses[bank]; }
+  uint64_t row_hits(void);
+  uint64_t row_misses(void);
+  double row_hit_rate(void);
+  uint64_t data_cycles(void) { return m_data_cycles; }
+  uint64_t idle_cycles(void) { return m_idle_cycles; }
+  uint64_t turnarounds(void) { return m_turnarounds; }
+  uint64_t reopens(void) { return m_reopens; }
+  double data_utilization(void) {
+    return m_cycles ? (double)m_data_cycles / m_cycles : 0.0;
+  }
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+protected:
+  void reset_stats(void);
+  void process(void);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  int m_chip;
+  uint64_t m_cycle;
+  bool m_enabled;
+  std::vector<tb_sdram_observer *> m_observers;
+
+  // Bank activated but not yet accessed
+  bool m_fresh[SDRAM_BANKS];
+
+  // Row per bank: open, and last closed by a single bank PRE (-1 none)
+  int m_open_row[SDRAM_BANKS];
+  int m_closed_row[SDRAM_BANKS];
+
+  // Data bus occupancy (bit n = busy n cycles from now)
+  uint64_t m_data_busy;
+
+  // Last RD / WR issued
+  int m_last_dir;
+
+  // Stats
+  uint64_t m_cycles;
+  uint64_t m_cmd[SDRAM_CMD_MAX];
+  uint64_t m_bank_cmd[SDRAM_BANKS][SDRAM_CMD_MAX];
+  uint64_t m_row_hits[SDRAM_BANKS];
+  uint64_t m_row_misses[SDRAM_BANKS];
+  uint64_t m_data_cycles;
+  uint64_t m_idle_cycles;
+  uint64_t m_turnarounds;
+  uint64_t m_reopens;
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "tb_sdram_power.h"
+#include <string.h>
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_sdram_power::tb_sdram_power() {
+  // Nominal MT48LC16M16A2 (-75) values, load the vendor table for
+  // anything that matters
+  m_idd.name = "MT48LC16M16A2";
+  m_idd.vdd = 3.3;
+  m_idd.idd0 = 115;
+  m_idd.idd2n = 30;
+  m_idd.idd3n = 40;
+  m_idd.idd4r = 115;
+  m_idd.idd4w = 115;
+  m_idd.idd5 = 215;
+  m_idd.tras = 44;
+  m_idd.trc = 66;
+  m_idd.trfc = 66;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    m_open[c] = 0;
+    m_burst_cmd[c] = SDRAM_CMD_NOP;
+    m_burst_left[c] = 0;
+  }
+
+  start();
+}
+//-----------------------------------------------------------------
+// start: Clear counters and open the window (bank state is kept)
+//-----------------------------------------------------------------
+void tb_sdram_power::start(void) {
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    m_cycles[c] = 0;
+    m_active_cycles[c] = 0;
+    m_rd_beats[c] = 0;
+    m_wr_beats[c] = 0;
+    for (int i = 0; i < SDRAM_CMD_MAX; i++)
+      m_cmd[c][i] = 0;
+  }
+  m_enabled = true;
+}
+//-----------------------------------------------------------------
+// set_value: Apply one config entry
+//-----------------------------------------------------------------
+bool tb_sdram_power::set_value(const char *key, const char *value) {
+  if (!strcasecmp(key, "name")) {
+    m_idd.name = value;
+    return true;
+  }
+
+  // Everything else is a number, and all of the value must parse
+  char *end;
+  double v = strtod(value, &end);
+  if (end == value || *end)
+    return false;
+
+  if (!strcasecmp(key, "vdd"))
+    m_idd.vdd = v;
+  else if (!strcasecmp(key, "idd0"))
+    m_idd.idd0 = v;
+  else if (!strcasecmp(key, "idd2n"))
+    m_idd.idd2n = v;
+  else if (!strcasecmp(key, "idd3n"))
+    m_idd.idd3n = v;
+  else if (!strcasecmp(key, "idd4r"))
+    m_idd.idd4r = v;
+  else if (!strcasecmp(key, "idd4w"))
+    m_idd.idd4w = v;
+  else if (!strcasecmp(key, "idd5"))
+    m_idd.idd5 = v;
+  else if (!strcasecmp(key, "tras"))
+    m_idd.tras = v;
+  else if (!strcasecmp(key, "trc"))
+    m_idd.trc = v;
+  else if (!strcasecmp(key, "trfc"))
+    m_idd.trfc = v;
+  else
+    return false;
+
+  return true;
+}
+//-----------------------------------------------------------------
+// load: Read a current table (missing keys keep their default)
+//-----------------------------------------------------------------
+bool tb_sdram_power::load(const char *filename) {
+  FILE *f = fopen(filename, "r");
+  if (!f) {
+    printf("ERROR: Could not open %s\n", filename);
+    return false;
+  }
+
+  char line[256];
+  int line_no = 0;
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), f)) {
+    line_no++;
+
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = 0;
+    char *eq = strchr(line, '=');
+    if (eq)
+      *eq = ' ';
+
+    char key[32], value[64];
+    int n = sscanf(line, "%31s %63s", key, value);
+    if (n <= 0)
+      continue;
+
+    if (n < 2 || !set_value(key, value)) {
+      printf("ERROR: %s:%d: Expected 'key value' (vdd, idd0, idd2n, idd3n, "
+             "idd4r, idd4w, idd5, tras, trc, trfc, name)\n",
+             filename, line_no);
+      ok = false;
+    }
+  }
+
+  fclose(f);
+  return ok;
+}
+//-----------------------------------------------------------------
+// component_name: Printable component
+//-----------------------------------------------------------------
+const char *tb_sdram_power::component_name(int component) {
+  switch (component) {
+  case TB_POWER_PRE_STANDBY:
+    return "precharge_standby";
+  case TB_POWER_ACT_STANDBY:
+    return "active_standby";
+  case TB_POWER_ACTIVATE:
+    return "activate";
+  case TB_POWER_READ:
+    return "read";
+  case TB_POWER_WRITE:
+    return "write";
+  case TB_POWER_REFRESH:
+    return "refresh";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// sdram_cycle: Track bank residency and count commands
+//-----------------------------------------------------------------
+void tb_sdram_power::sdram_cycle(int chip, uint64_t, int cmd,
+                                 const sdram_io &io) {
+  // Residency of the state going into this cycle
+  if (m_enabled) {
+    m_cycles[chip]++;
+    if (m_open[chip])
+      m_active_cycles[chip]++;
+    m_cmd[chip][cmd]++;
+  }
+
+  uint32_t bank_mask = 1 << (int)io.BA;
+  bool a10 = (io.ADDR >> SDRAM_AUTO_PRECHARGE_BIT) & 1;
+
+  switch (cmd) {
+  case SDRAM_CMD_ACTIVE:
+    m_open[chip] |= bank_mask;
+    break;
+  case SDRAM_CMD_READ:
+  case SDRAM_CMD_WRITE:
+    if (a10)
+      m_open[chip] &= ~bank_mask;
+    m_burst_cmd[chip] = cmd;
+    m_burst_left[chip] = SDRAM_BURST_LEN;
+    break;
+  case SDRAM_CMD_TERMINATE:
+    m_burst_left[chip] = 0;
+    break;
+  case SDRAM_CMD_PRECHARGE:
+    m_open[chip] &= a10 ? 0 : ~bank_mask;
+    m_burst_left[chip] = 0;
+    break;
+  default:
+    break;
+  }
+
+  // Data beats, counted from the command cycle
+  if (m_burst_left[chip] > 0) {
+    m_burst_left[chip]--;
+    if (m_enabled && m_burst_cmd[chip] == SDRAM_CMD_READ)
+      m_rd_beats[chip]++;
+    else if (m_enabled)
+      m_wr_beats[chip]++;
+  }
+}
+//-----------------------------------------------------------------
+// energy: Energy of one component on one chip (pJ)
+//-----------------------------------------------------------------
+double tb_sdram_power::energy(int chip, int component) {
+  const double tck = 1000.0 / SDRAM_MHZ;
+  const tb_sdram_idd &t = m_idd;
+
+  switch (component) {
+  case TB_POWER_PRE_STANDBY:
+    return (m_cycles[chip] - m_active_cycles[chip]) * tck * t.idd2n * t.vdd;
+  case TB_POWER_ACT_STANDBY:
+    return m_active_cycles[chip] * tck * t.idd3n * t.vdd;
+  case TB_POWER_ACTIVATE:
+    // IDD0 over tRC, less the standby current already counted
+    return m_cmd[chip][SDRAM_CMD_ACTIVE] * t.vdd *
+           (t.idd0 * t.trc -
+            (t.idd3n * t.tras + t.idd2n * (t.trc - t.tras)));
+  case TB_POWER_READ:
+    return m_rd_beats[chip] * t.vdd * (t.idd4r - t.idd3n) * tck;
+  case TB_POWER_WRITE:
+    return m_wr_beats[chip] * t.vdd * (t.idd4w - t.idd3n) * tck;
+  case TB_POWER_REFRESH:
+    return m_cmd[chip][SDRAM_CMD_REFRESH] * t.vdd * (t.idd5 - t.idd3n) *
+           t.trfc;
+  default:
+    return 0.0;
+  }
+}
+//-----------------------------------------------------------------
+// energy: Total over all chips and components (pJ)
+//-----------------------------------------------------------------
+double tb_sdram_power::energy(void) {
+  double total = 0.0;
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    for (int i = 0; i < TB_POWER_MAX; i++)
+      total += energy(c, i);
+  return total;
+}
+//-----------------------------------------------------------------
+// bytes: Data transferred on the SDRAM pins
+//-----------------------------------------------------------------
+uint64_t tb_sdram_power::bytes(void) {
+  uint64_t beats = 0;
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    beats += m_rd_beats[c] + m_wr_beats[c];
+  return beats * (SDRAM_DATA_W / 8);
+}
+//-----------------------------------------------------------------
+// avg_power_mw: Average power over the window (pJ / ns = mW)
+//-----------------------------------------------------------------
+double tb_sdram_power::avg_power_mw(void) {
+  double ns = m_cycles[0] * (1000.0 / SDRAM_MHZ);
+  return ns > 0 ? energy() / ns : 0.0;
+}
+//-----------------------------------------------------------------
+// pj_per_byte: Energy per byte transferred
+//-----------------------------------------------------------------
+double tb_sdram_power::pj_per_byte(void) {
+  uint64_t b = bytes();
+  return b ? energy() / b : 0.0;
+}
+//-----------------------------------------------------------------
+// print_stats: Summary to stdout
+//-----------------------------------------------------------------
+void tb_sdram_power::print_stats(void) {
+  double total = energy();
+
+  printf("POWER: %s (VDD %.2fV): %.1f nJ over %llu cycles, avg %.1f mW, "
+         "%.1f pJ/byte (%llu bytes)\n",
+         m_idd.name.c_str(), m_idd.vdd, total / 1000.0,
+         (unsigned long long)m_cycles[0], avg_power_mw(), pj_per_byte(),
+         (unsigned long long)bytes());
+
+  for (int i = 0; i < TB_POWER_MAX; i++) {
+    double e = 0.0;
+    for (int c = 0; c < SDRAM_CHIPS; c++)
+      e += energy(c, i);
+    printf("POWER:   %-18s %10.1f nJ (%.1f%%)\n", component_name(i),
+           e / 1000.0, total > 0 ? (100.0 * e) / total : 0.0);
+  }
+
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    printf("POWER:   chip %d bank active residency %.1f%%\n", c,
+           m_cycles[c] ? (100.0 * m_active_cycles[c]) / m_cycles[c] : 0.0);
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_sdram_power::write_json(tb_json &js) {
+  js.value("part", m_idd.name.c_str());
+  js.value("vdd", m_idd.vdd);
+  js.value("energy_pj", energy());
+  js.value("avg_power_mw", avg_power_mw());
+  js.value("bytes", bytes());
+  js.value("pj_per_byte", pj_per_byte());
+
+  js.begin_array("chips");
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    js.begin_object();
+    js.value("chip", c);
+    js.value("cycles", m_cycles[c]);
+    js.value("active_cycles", m_active_cycles[c]);
+    for (int i = 0; i < TB_POWER_MAX; i++)
+      js.value(component_name(i), energy(c, i));
+    js.end_object();
+  }
+  js.end_array();
+}
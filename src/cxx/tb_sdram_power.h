@@ -0,0 +1,99 @@
+#ifndef TB_SDRAM_POWER_H
+#define TB_SDRAM_POWER_H
+
+#include "tb_sdram_monitor.h"
+#include <string>
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_POWER_COMPONENT {
+  TB_POWER_PRE_STANDBY, // All banks precharged (IDD2N)
+  TB_POWER_ACT_STANDBY, // At least one bank open (IDD3N)
+  TB_POWER_ACTIVATE,    // ACT / PRE pair (IDD0)
+  TB_POWER_READ,        // Read burst (IDD4R)
+  TB_POWER_WRITE,       // Write burst (IDD4W)
+  TB_POWER_REFRESH,     // Auto refresh (IDD5)
+  TB_POWER_MAX
+};
+
+//-------------------------------------------------------------
+// tb_sdram_idd: Vendor current table (mA, V, ns)
+//-------------------------------------------------------------
+struct tb_sdram_idd {
+  std::string name;
+  double vdd;
+  double idd0;
+  double idd2n;
+  double idd3n;
+  double idd4r;
+  double idd4w;
+  double idd5;
+  double tras;
+  double trc;
+  double trfc;
+};
+
+//-------------------------------------------------------------
+// tb_sdram_power: IDD based energy estimate (all chips)
+//   Micron style power calculation from command counts, data
+//   beats (a burst ends after BL beats, at BST or the next
+//   RD / WR / PRE) and bank active residency. CKE is never dropped by the core,
+//   so power down / self refresh states are not modelled, nor
+//   is I/O or termination power.
+//
+//   Config file: one 'key value' (or 'key = value') per line,
+//   '#' starts a comment. Keys: name, vdd, idd0, idd2n, idd3n,
+//   idd4r, idd4w, idd5 (mA) and tras, trc, trfc (ns).
+//-------------------------------------------------------------
+class tb_sdram_power : public tb_sdram_observer {
+public:
+  tb_sdram_power();
+
+  bool load(const char *filename);
+  const tb_sdram_idd &idd(void) { return m_idd; }
+
+  // Measurement window (enabled from construction)
+  void start(void);
+  void stop(void) { m_enabled = false; }
+
+  // Energy in pJ (mA x V x ns)
+  double energy(int chip, int component);
+  double energy(void);
+
+  uint64_t bytes(void);
+  double avg_power_mw(void);
+  double pj_per_byte(void);
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+  void sdram_cycle(int chip, uint64_t cycle, int cmd, const sdram_io &io);
+
+  static const char *component_name(int component);
+
+protected:
+  bool set_value(const char *key, const char *value);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  tb_sdram_idd m_idd;
+  bool m_enabled;
+
+  // Open banks (bit per bank), tracked outside the window too
+  uint32_t m_open[SDRAM_CHIPS];
+
+  // Running burst: RD / WR and beats left
+  int m_burst_cmd[SDRAM_CHIPS];
+  int m_burst_left[SDRAM_CHIPS];
+
+  // Window counts
+  uint64_t m_cycles[SDRAM_CHIPS];
+  uint64_t m_active_cycles[SDRAM_CHIPS];
+  uint64_t m_cmd[SDRAM_CHIPS][SDRAM_CMD_MAX];
+  uint64_t m_rd_beats[SDRAM_CHIPS];
+  uint64_t m_wr_beats[SDRAM_CHIPS];
+};
+
+#endif
@@ -0,0 +1,333 @@
+#include "tb_sdram_timing.h"
+#include <string.h>
+
+//-----------------------------------------------------------------
+// Profiles
+//   params:         SdramParams tRCD / tRP / tRAS / tRRD / tWR / tRFC,
+//                   rest as -6A
+//   MT48LC16M16A2:  Micron 256Mb, -75 speed grade
+//   AS4C16M16S:     Alliance 256Mb, -6 speed grade
+//-----------------------------------------------------------------
+static const tb_sdram_profile g_profiles[] = {
+    // name, tRCD, tRP, tRAS, tRC, tRRD, tWR, tRFC, tMRD (clk), tREF (ms)
+    {"params", SDRAM_TRCD_NS, SDRAM_TRP_NS, SDRAM_TRAS_NS, 60, SDRAM_TRRD_NS,
+     SDRAM_TWR_NS, SDRAM_TRFC_NS, 2, 64},
+    {"MT48LC16M16A2", 20, 20, 44, 66, 15, 15, 66, 2, 64},
+    {"AS4C16M16S", 18, 18, 42, 60, 12, 12, 60, 2, 64},
+};
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_sdram_timing::tb_sdram_timing() {
+  m_fatal = false;
+  m_reported = 0;
+
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    for (int b = 0; b < SDRAM_BANKS; b++) {
+      m_bank[c][b].open = false;
+      m_bank[c][b].act = 0;
+      m_bank[c][b].pre = 0;
+      m_bank[c][b].wr_data = 0;
+    }
+    m_last_act[c] = 0;
+    m_last_act_bank[c] = -1;
+    m_last_ref[c] = 0;
+    m_first_ref[c] = 0;
+    m_ref_count[c] = 0;
+    m_max_owed[c] = 0;
+    m_last_mrs[c] = 0;
+    m_last_wr_bank[c] = -1;
+  }
+
+  for (int r = 0; r < TB_TIMING_MAX; r++)
+    m_violations[r] = 0;
+
+  set_profile("params");
+}
+//-----------------------------------------------------------------
+// set_profile: Select datasheet timing by name
+//-----------------------------------------------------------------
+bool tb_sdram_timing::set_profile(const char *name) {
+  int count = sizeof(g_profiles) / sizeof(g_profiles[0]);
+
+  for (int i = 0; i < count; i++) {
+    if (strcasecmp(g_profiles[i].name, name))
+      continue;
+
+    m_profile = g_profiles[i];
+    m_trcd = ns_to_cycles(m_profile.tRCD);
+    m_trp = ns_to_cycles(m_profile.tRP);
+    m_tras = ns_to_cycles(m_profile.tRAS);
+    m_trc = ns_to_cycles(m_profile.tRC);
+    m_trrd = ns_to_cycles(m_profile.tRRD);
+    m_twr = ns_to_cycles(m_profile.tWR);
+    m_trfc = ns_to_cycles(m_profile.tRFC);
+    m_tmrd = m_profile.tMRD_clk;
+    m_trefi = ((uint64_t)m_profile.tREF_ms * 1000 * SDRAM_MHZ) / SDRAM_ROWS;
+    return true;
+  }
+
+  printf("ERROR: Unknown SDRAM profile '%s'\n", name);
+  return false;
+}
+//-----------------------------------------------------------------
+// rule_name: Printable rule
+//-----------------------------------------------------------------
+const char *tb_sdram_timing::rule_name(int rule) {
+  switch (rule) {
+  case TB_TIMING_TRCD:
+    return "tRCD";
+  case TB_TIMING_TRP:
+    return "tRP";
+  case TB_TIMING_TRAS:
+    return "tRAS";
+  case TB_TIMING_TRC:
+    return "tRC";
+  case TB_TIMING_TRRD:
+    return "tRRD";
+  case TB_TIMING_TWR:
+    return "tWR";
+  case TB_TIMING_TRFC:
+    return "tRFC";
+  case TB_TIMING_TMRD:
+    return "tMRD";
+  case TB_TIMING_STATE:
+    return "bank_state";
+  case TB_TIMING_REFRESH:
+    return "refresh_interval";
+  case TB_TIMING_REFRESH_WINDOW:
+    return "refresh_window";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// violation: Count (and report the first few) violations
+//-----------------------------------------------------------------
+void tb_sdram_timing::violation(int rule, int chip, int bank, uint64_t cycle,
+                                int cmd, const char *detail) {
+  m_violations[rule]++;
+
+  if (m_reported < TB_TIMING_MAX_REPORTS || m_fatal) {
+    printf("TIMING: cycle %llu chip %d bank %d %s: %s violation (%s)\n",
+           (unsigned long long)cycle, chip, bank, sdram_io::command_name(cmd),
+           rule_name(rule), detail);
+    if (++m_reported == TB_TIMING_MAX_REPORTS)
+      printf("TIMING: Further violations are counted only\n");
+  }
+
+  sc_assert(!m_fatal);
+}
+//-----------------------------------------------------------------
+// check: Minimum distance from an earlier command
+//-----------------------------------------------------------------
+void tb_sdram_timing::check(int rule, int chip, int bank, uint64_t cycle,
+                            int cmd, uint64_t last, int min_cycles) {
+  if (!last || cycle >= last + min_cycles)
+    return;
+
+  char detail[64];
+  sprintf(detail, "%llu cycles, needs %d", (unsigned long long)(cycle - last),
+          min_cycles);
+  violation(rule, chip, bank, cycle, cmd, detail);
+}
+//-----------------------------------------------------------------
+// sdram_cycle: Check one decoded command
+//-----------------------------------------------------------------
+void tb_sdram_timing::sdram_cycle(int chip, uint64_t cycle, int cmd,
+                                  const sdram_io &io) {
+  if (cmd == SDRAM_CMD_NOP)
+    return;
+
+  int bank = (int)io.BA;
+  bool a10 = (io.ADDR >> SDRAM_AUTO_PRECHARGE_BIT) & 1;
+  bank_state &b = m_bank[chip][bank];
+
+  check(TB_TIMING_TMRD, chip, bank, cycle, cmd, m_last_mrs[chip], m_tmrd);
+
+  // BST or a new RD / WR cuts a write burst short (last data the
+  // cycle before)
+  if ((cmd == SDRAM_CMD_TERMINATE || cmd == SDRAM_CMD_READ ||
+       cmd == SDRAM_CMD_WRITE) &&
+      m_last_wr_bank[chip] >= 0) {
+    bank_state &w = m_bank[chip][m_last_wr_bank[chip]];
+    if (w.wr_data >= cycle)
+      w.wr_data = cycle - 1;
+    m_last_wr_bank[chip] = -1;
+  }
+
+  switch (cmd) {
+  case SDRAM_CMD_ACTIVE:
+    if (b.open)
+      violation(TB_TIMING_STATE, chip, bank, cycle, cmd, "bank already open");
+    check(TB_TIMING_TRP, chip, bank, cycle, cmd, b.pre, m_trp);
+    check(TB_TIMING_TRC, chip, bank, cycle, cmd, b.act, m_trc);
+    check(TB_TIMING_TRFC, chip, bank, cycle, cmd, m_last_ref[chip], m_trfc);
+    if (m_last_act_bank[chip] != bank)
+      check(TB_TIMING_TRRD, chip, bank, cycle, cmd, m_last_act[chip], m_trrd);
+
+    b.open = true;
+    b.act = cycle;
+    m_last_act[chip] = cycle;
+    m_last_act_bank[chip] = bank;
+    break;
+
+  case SDRAM_CMD_READ:
+  case SDRAM_CMD_WRITE:
+    if (!b.open)
+      violation(TB_TIMING_STATE, chip, bank, cycle, cmd, "bank not open");
+    check(TB_TIMING_TRCD, chip, bank, cycle, cmd, b.act, m_trcd);
+
+    if (cmd == SDRAM_CMD_WRITE) {
+      b.wr_data = cycle + SDRAM_BURST_LEN - 1;
+      m_last_wr_bank[chip] = bank;
+    }
+
+    // Auto precharge: starts after the burst (write: after tWR)
+    if (a10) {
+      b.open = false;
+      b.pre = (cmd == SDRAM_CMD_WRITE) ? (b.wr_data + m_twr)
+                                       : (cycle + SDRAM_BURST_LEN);
+    }
+    break;
+
+  case SDRAM_CMD_PRECHARGE:
+    for (int i = 0; i < SDRAM_BANKS; i++) {
+      bank_state &p = m_bank[chip][i];
+      if ((!a10 && i != bank) || !p.open)
+        continue;
+
+      check(TB_TIMING_TRAS, chip, i, cycle, cmd, p.act, m_tras);
+      check(TB_TIMING_TWR, chip, i, cycle, cmd, p.wr_data, m_twr);
+      p.open = false;
+      p.pre = cycle;
+    }
+    break;
+
+  case SDRAM_CMD_REFRESH:
+    for (int i = 0; i < SDRAM_BANKS; i++) {
+      bank_state &p = m_bank[chip][i];
+      if (p.open)
+        violation(TB_TIMING_STATE, chip, i, cycle, cmd, "bank open");
+      check(TB_TIMING_TRP, chip, i, cycle, cmd, p.pre, m_trp);
+    }
+    check(TB_TIMING_TRFC, chip, bank, cycle, cmd, m_last_ref[chip], m_trfc);
+
+    // Up to 8 refreshes may be postponed
+    if (m_last_ref[chip] && (cycle - m_last_ref[chip]) > 9 * m_trefi) {
+      char detail[64];
+      sprintf(detail, "%llu cycles since last REF, max %llu",
+              (unsigned long long)(cycle - m_last_ref[chip]),
+              (unsigned long long)(9 * m_trefi));
+      violation(TB_TIMING_REFRESH, chip, bank, cycle, cmd, detail);
+    }
+
+    // Average rate: one REF per tREFI, at most 8 behind
+    if (m_ref_count[chip]) {
+      int owed = refresh_owed(chip, cycle);
+      if (owed > m_max_owed[chip])
+        m_max_owed[chip] = owed;
+      if (owed > 8) {
+        char detail[64];
+        sprintf(detail, "%d REFs owed, max 8", owed);
+        violation(TB_TIMING_REFRESH_WINDOW, chip, bank, cycle, cmd, detail);
+      }
+    } else
+      m_first_ref[chip] = cycle;
+    m_ref_count[chip]++;
+    m_last_ref[chip] = cycle;
+    break;
+
+  case SDRAM_CMD_LOAD_MODE:
+    for (int i = 0; i < SDRAM_BANKS; i++)
+      if (m_bank[chip][i].open)
+        violation(TB_TIMING_STATE, chip, i, cycle, cmd, "bank open");
+    m_last_mrs[chip] = cycle;
+    break;
+
+  default:
+    break;
+  }
+}
+//-----------------------------------------------------------------
+// refresh_owed: REFs due (one per tREFI from the first) not issued
+//-----------------------------------------------------------------
+int tb_sdram_timing::refresh_owed(int chip, uint64_t cycle) {
+  if (!m_ref_count[chip])
+    return 0;
+  int64_t due = (int64_t)((cycle - m_first_ref[chip]) / m_trefi) + 1;
+  return (int)(due - (int64_t)m_ref_count[chip]);
+}
+//-----------------------------------------------------------------
+// finish: Trailing refresh interval at the end of the run
+//-----------------------------------------------------------------
+void tb_sdram_timing::finish(uint64_t cycle) {
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    int owed = refresh_owed(c, cycle);
+    if (owed > m_max_owed[c])
+      m_max_owed[c] = owed;
+    if (owed > 8) {
+      char detail[64];
+      sprintf(detail, "%d REFs owed at end of run", owed);
+      violation(TB_TIMING_REFRESH_WINDOW, c, -1, cycle, SDRAM_CMD_NOP,
+                detail);
+    }
+
+    if (!m_last_ref[c] || (cycle - m_last_ref[c]) <= 9 * m_trefi)
+      continue;
+
+    char detail[64];
+    sprintf(detail, "no REF for %llu cycles at end of run",
+            (unsigned long long)(cycle - m_last_ref[c]));
+    violation(TB_TIMING_REFRESH, c, -1, cycle, SDRAM_CMD_NOP, detail);
+  }
+}
+//-----------------------------------------------------------------
+// violations: Total over all rules
+//-----------------------------------------------------------------
+uint64_t tb_sdram_timing::violations(void) {
+  uint64_t total = 0;
+  for (int r = 0; r < TB_TIMING_MAX; r++)
+    total += m_violations[r];
+  return total;
+}
+//-----------------------------------------------------------------
+// print_stats: Summary to stdout
+//-----------------------------------------------------------------
+void tb_sdram_timing::print_stats(void) {
+  printf("TIMING: profile %s (tRCD %d tRP %d tRAS %d tRC %d tRRD %d tWR %d "
+         "tRFC %d tMRD %d tREFI %llu cycles): %llu violations\n",
+         m_profile.name, m_trcd, m_trp, m_tras, m_trc, m_trrd, m_twr, m_trfc,
+         m_tmrd, (unsigned long long)m_trefi,
+         (unsigned long long)violations());
+
+  for (int r = 0; r < TB_TIMING_MAX; r++)
+    if (m_violations[r])
+      printf("TIMING:   %s: %llu\n", rule_name(r),
+             (unsigned long long)m_violations[r]);
+
+  for (int c = 0; c < SDRAM_CHIPS; c++)
+    printf("TIMING: refresh chip%d: %llu REF, max %d postponed (limit 8)\n",
+           c, (unsigned long long)m_ref_count[c], m_max_owed[c]);
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_sdram_timing::write_json(tb_json &js) {
+  js.value("profile", m_profile.name);
+  js.value("total", violations());
+  for (int r = 0; r < TB_TIMING_MAX; r++)
+    js.value(rule_name(r), m_violations[r]);
+
+  js.begin_object("refresh");
+  for (int c = 0; c < SDRAM_CHIPS; c++) {
+    char name[16];
+    sprintf(name, "chip%d", c);
+    js.begin_object(name);
+    js.value("count", m_ref_count[c]);
+    js.value("max_postponed", m_max_owed[c]);
+    js.end_object();
+  }
+  js.end_object();
+}
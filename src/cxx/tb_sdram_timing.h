@@ -0,0 +1,121 @@
+#ifndef TB_SDRAM_TIMING_H
+#define TB_SDRAM_TIMING_H
+
+#include "tb_sdram_monitor.h"
+
+#define TB_TIMING_MAX_REPORTS 20
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_TIMING_RULE {
+  TB_TIMING_TRCD,           // ACT -> RD / WR (same bank)
+  TB_TIMING_TRP,            // PRE -> ACT / REF
+  TB_TIMING_TRAS,           // ACT -> PRE (same bank)
+  TB_TIMING_TRC,            // ACT -> ACT (same bank)
+  TB_TIMING_TRRD,           // ACT -> ACT (other bank)
+  TB_TIMING_TWR,            // Last write data -> PRE (same bank)
+  TB_TIMING_TRFC,           // REF -> ACT / REF
+  TB_TIMING_TMRD,           // MRS -> any command
+  TB_TIMING_STATE,          // RD / WR to a closed bank, ACT to an open
+                            // bank, REF or MRS with banks open
+  TB_TIMING_REFRESH,        // Refresh interval beyond 9 x tREFI
+  TB_TIMING_REFRESH_WINDOW, // More than 8 REFs owed (tREF window)
+  TB_TIMING_MAX
+};
+
+//-------------------------------------------------------------
+// tb_sdram_profile: Datasheet timing (ns unless noted)
+//-------------------------------------------------------------
+struct tb_sdram_profile {
+  const char *name;
+  int tRCD;
+  int tRP;
+  int tRAS;
+  int tRC;
+  int tRRD;
+  int tWR;
+  int tRFC;
+  int tMRD_clk;
+  int tREF_ms; // Refresh window for all rows
+};
+
+//-------------------------------------------------------------
+// tb_sdram_timing: JEDEC timing checker (all chips)
+//   Tracks the last ACT / PRE / RD / WR / REF / MRS cycle per
+//   bank and checks every command against the selected profile.
+//   Only commands do work, so the cost per NOP cycle is a
+//   single compare.
+//-------------------------------------------------------------
+class tb_sdram_timing : public tb_sdram_observer {
+public:
+  tb_sdram_timing();
+
+  // Profile: "params" (SdramParams + conservative rest),
+  // "MT48LC16M16A2" or "AS4C16M16S"
+  bool set_profile(const char *name);
+  const char *profile(void) { return m_profile.name; }
+
+  // Abort on the first violation
+  void set_fatal(bool fatal) { m_fatal = fatal; }
+
+  // End of run: check the trailing refresh interval
+  void finish(uint64_t cycle);
+
+  uint64_t violations(void);
+  uint64_t violations(int rule) { return m_violations[rule]; }
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+  void sdram_cycle(int chip, uint64_t cycle, int cmd, const sdram_io &io);
+
+  static int ns_to_cycles(int ns) { return (ns * SDRAM_MHZ + 999) / 1000; }
+  static const char *rule_name(int rule);
+
+protected:
+  void check(int rule, int chip, int bank, uint64_t cycle, int cmd,
+             uint64_t last, int min_cycles);
+  void violation(int rule, int chip, int bank, uint64_t cycle, int cmd,
+                 const char *detail);
+  int refresh_owed(int chip, uint64_t cycle);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  tb_sdram_profile m_profile;
+  bool m_fatal;
+
+  // Limits in clock cycles
+  int m_trcd;
+  int m_trp;
+  int m_tras;
+  int m_trc;
+  int m_trrd;
+  int m_twr;
+  int m_trfc;
+  int m_tmrd;
+  uint64_t m_trefi;
+
+  // Last command cycle (0 = never)
+  struct bank_state {
+    bool open;
+    uint64_t act;
+    uint64_t pre;
+    uint64_t wr_data;
+  };
+  bank_state m_bank[SDRAM_CHIPS][SDRAM_BANKS];
+  uint64_t m_last_act[SDRAM_CHIPS];
+  int m_last_act_bank[SDRAM_CHIPS];
+  uint64_t m_last_ref[SDRAM_CHIPS];
+  uint64_t m_first_ref[SDRAM_CHIPS];
+  uint64_t m_ref_count[SDRAM_CHIPS];
+  int m_max_owed[SDRAM_CHIPS]; // Most REFs postponed at once
+  uint64_t m_last_mrs[SDRAM_CHIPS];
+  int m_last_wr_bank[SDRAM_CHIPS]; // Bank of the last WRITE burst
+
+  uint64_t m_violations[TB_TIMING_MAX];
+  int m_reported;
+};
+
+#endif
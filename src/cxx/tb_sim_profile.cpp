@@ -0,0 +1,164 @@
+#include "tb_sim_profile.h"
+#include <algorithm>
+#include <sys/resource.h>
+
+bool tb_sim_profile::s_detail = false;
+uint64_t tb_sim_profile::s_ns[TB_PROF_MAX];
+uint64_t tb_sim_profile::s_activations[TB_PROF_MAX];
+
+//-----------------------------------------------------------------
+// Constructor
+//-----------------------------------------------------------------
+tb_sim_profile::tb_sim_profile() {
+  m_open = false;
+  m_created_ns = now_ns();
+  m_start_ns = m_created_ns;
+  m_elab_ns = 0;
+  m_start_cycles = 0;
+  m_start_deltas = 0;
+  for (int i = 0; i < TB_PROF_MAX; i++) {
+    m_start_prof_ns[i] = 0;
+    m_start_activations[i] = 0;
+  }
+}
+//-----------------------------------------------------------------
+// category_name: Printable category
+//-----------------------------------------------------------------
+const char *tb_sim_profile::category_name(int category) {
+  switch (category) {
+  case TB_PROF_TESTBENCH:
+    return "testbench";
+  case TB_PROF_DUT_WRAPPER:
+    return "dut_wrapper";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// cycles_now: Simulated clock cycles so far
+//-----------------------------------------------------------------
+uint64_t tb_sim_profile::cycles_now(void) {
+  if (m_period == SC_ZERO_TIME)
+    return 0;
+  return (uint64_t)(sc_time_stamp() / m_period);
+}
+//-----------------------------------------------------------------
+// peak_rss_kb: Peak resident set size of the process
+//-----------------------------------------------------------------
+long tb_sim_profile::peak_rss_kb(void) {
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru))
+    return 0;
+  return ru.ru_maxrss;
+}
+//-----------------------------------------------------------------
+// begin_phase: Close the current phase and start another
+//-----------------------------------------------------------------
+void tb_sim_profile::begin_phase(const char *name) {
+  end();
+
+  phase p;
+  p.name = name;
+  m_phases.push_back(p);
+  m_open = true;
+
+  m_start_ns = now_ns();
+  if (m_phases.size() == 1)
+    m_elab_ns = m_start_ns - m_created_ns;
+  m_start_cycles = cycles_now();
+  m_start_deltas = sc_delta_count();
+  for (int i = 0; i < TB_PROF_MAX; i++) {
+    m_start_prof_ns[i] = s_ns[i];
+    m_start_activations[i] = s_activations[i];
+  }
+}
+//-----------------------------------------------------------------
+// end: Close the current phase
+//-----------------------------------------------------------------
+void tb_sim_profile::end(void) {
+  if (!m_open)
+    return;
+
+  phase &p = m_phases.back();
+  p.wall_ns = now_ns() - m_start_ns;
+  p.cycles = cycles_now() - m_start_cycles;
+  p.deltas = sc_delta_count() - m_start_deltas;
+  p.rss_kb = peak_rss_kb();
+  for (int i = 0; i < TB_PROF_MAX; i++) {
+    p.ns[i] = s_ns[i] - m_start_prof_ns[i];
+    p.activations[i] = s_activations[i] - m_start_activations[i];
+  }
+  m_open = false;
+}
+//-----------------------------------------------------------------
+// print_stats: Summary to stdout
+//-----------------------------------------------------------------
+void tb_sim_profile::print_stats(void) {
+  uint64_t total_ns = 0;
+  uint64_t total_cycles = 0;
+
+  printf("PROFILE: elab     %.3fs wall\n", m_elab_ns / 1e9);
+
+  for (size_t i = 0; i < m_phases.size(); i++) {
+    const phase &p = m_phases[i];
+    double secs = p.wall_ns / 1e9;
+
+    printf("PROFILE: %-8s %.3fs wall, %llu cycles, %.1f kHz, "
+           "%.2f deltas/cycle, peak RSS %ld KB\n",
+           p.name.c_str(), secs, (unsigned long long)p.cycles,
+           secs > 0 ? p.cycles / secs / 1000.0 : 0.0,
+           p.cycles ? (double)p.deltas / p.cycles : 0.0, p.rss_kb);
+
+    if (s_detail && p.wall_ns) {
+      uint64_t other = p.wall_ns;
+      printf("PROFILE: %-8s", p.name.c_str());
+      for (int c = 0; c < TB_PROF_MAX; c++) {
+        other -= std::min(other, p.ns[c]);
+        printf(" %s %.1f%% (%.2f activations/cycle),", category_name(c),
+               (100.0 * p.ns[c]) / p.wall_ns,
+               p.cycles ? (double)p.activations[c] / p.cycles : 0.0);
+      }
+      printf(" verilated eval + kernel %.1f%%\n",
+             (100.0 * other) / p.wall_ns);
+    }
+
+    total_ns += p.wall_ns;
+    total_cycles += p.cycles;
+  }
+
+  double secs = total_ns / 1e9;
+  printf("PROFILE: total    %.3fs wall, %llu cycles, %.1f kHz, "
+         "peak RSS %ld KB\n",
+         secs, (unsigned long long)total_cycles,
+         secs > 0 ? total_cycles / secs / 1000.0 : 0.0, peak_rss_kb());
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_sim_profile::write_json(tb_json &js) {
+  js.value("detail", s_detail);
+  js.value("elab_s", m_elab_ns / 1e9);
+  js.begin_array("phases");
+  for (size_t i = 0; i < m_phases.size(); i++) {
+    const phase &p = m_phases[i];
+    double secs = p.wall_ns / 1e9;
+
+    js.begin_object();
+    js.value("phase", p.name.c_str());
+    js.value("wall_s", secs);
+    js.value("cycles", p.cycles);
+    js.value("khz", secs > 0 ? p.cycles / secs / 1000.0 : 0.0);
+    js.value("deltas", p.deltas);
+    js.value("peak_rss_kb", (uint64_t)p.rss_kb);
+    if (s_detail) {
+      for (int c = 0; c < TB_PROF_MAX; c++) {
+        js.begin_object(category_name(c));
+        js.value("wall_s", p.ns[c] / 1e9);
+        js.value("activations", p.activations[c]);
+        js.end_object();
+      }
+    }
+    js.end_object();
+  }
+  js.end_array();
+}
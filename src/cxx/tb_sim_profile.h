@@ -0,0 +1,121 @@
+#ifndef TB_SIM_PROFILE_H
+#define TB_SIM_PROFILE_H
+
+#include <systemc.h>
+
+#include "tb_json.h"
+#include <string>
+#include <time.h>
+#include <vector>
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_PROF_CATEGORY {
+  TB_PROF_TESTBENCH,   // Drivers, monitors, interconnect
+  TB_PROF_DUT_WRAPPER, // sdram_axi pin conversion
+  TB_PROF_MAX
+};
+
+//-------------------------------------------------------------
+// tb_sim_profile: Simulator speed self-profiling
+//   Wall time, simulated cycles / kHz, delta cycles and peak RSS
+//   per phase (init, traffic). With set_detail(true) the
+//   instrumented processes (tb_prof_scope) are also timed; the
+//   remainder is Verilated eval plus the SystemC kernel, which
+//   cannot be separated from outside the generated model.
+//-------------------------------------------------------------
+class tb_sim_profile {
+public:
+  tb_sim_profile();
+
+  // Clock used to convert simulated time to cycles
+  void set_clock_period(const sc_time &period) { m_period = period; }
+
+  // Close the current phase (if any) and start another
+  void begin_phase(const char *name);
+  void end(void);
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+  // Process timing (opt-in)
+  static void set_detail(bool en) { s_detail = en; }
+  static bool detail(void) { return s_detail; }
+  static void account(int category, uint64_t ns) {
+    s_ns[category] += ns;
+    s_activations[category]++;
+  }
+
+  static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+  }
+
+  static const char *category_name(int category);
+
+protected:
+  uint64_t cycles_now(void);
+  static long peak_rss_kb(void);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  struct phase {
+    std::string name;
+    uint64_t wall_ns;
+    uint64_t cycles;
+    uint64_t deltas;
+    long rss_kb; // Peak at the end of the phase
+    uint64_t ns[TB_PROF_MAX];
+    uint64_t activations[TB_PROF_MAX];
+  };
+  std::vector<phase> m_phases;
+  bool m_open;
+  sc_time m_period;
+
+  // Construction to first phase (elaboration + setup)
+  uint64_t m_created_ns;
+  uint64_t m_elab_ns;
+
+  // Start of the current phase
+  uint64_t m_start_ns;
+  uint64_t m_start_cycles;
+  uint64_t m_start_deltas;
+  uint64_t m_start_prof_ns[TB_PROF_MAX];
+  uint64_t m_start_activations[TB_PROF_MAX];
+
+  static bool s_detail;
+  static uint64_t s_ns[TB_PROF_MAX];
+  static uint64_t s_activations[TB_PROF_MAX];
+};
+
+//-------------------------------------------------------------
+// tb_prof_scope: Times the enclosing block when detail is on
+//-------------------------------------------------------------
+class tb_prof_scope {
+public:
+  tb_prof_scope(int category) {
+    m_category = category;
+    m_active = tb_sim_profile::detail();
+    if (m_active)
+      m_start = tb_sim_profile::now_ns();
+  }
+  ~tb_prof_scope() { stop(); }
+
+  // End early (e.g. before a wait())
+  void stop(void) {
+    if (!m_active)
+      return;
+    tb_sim_profile::account(m_category, tb_sim_profile::now_ns() - m_start);
+    m_active = false;
+  }
+
+protected:
+  int m_category;
+  bool m_active;
+  uint64_t m_start;
+};
+
+#endif
@@ -0,0 +1,243 @@
+#include "tb_trace_replay.h"
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------
+// record_order: Sort by recorded cycle (stable, keeps file order)
+//-----------------------------------------------------------------
+static bool record_order(const tb_trace_record &a, const tb_trace_record &b) {
+  return a.cycle < b.cycle;
+}
+//-----------------------------------------------------------------
+// parse_burst: Burst type from name or number
+//-----------------------------------------------------------------
+static int parse_burst(const char *s) {
+  if (!strcasecmp(s, "FIXED"))
+    return AXI4_BURST_FIXED;
+  else if (!strcasecmp(s, "INCR"))
+    return AXI4_BURST_INCR;
+  else if (!strcasecmp(s, "WRAP"))
+    return AXI4_BURST_WRAP;
+  else
+    return strtol(s, NULL, 0);
+}
+//-----------------------------------------------------------------
+// load_text: Parse text trace
+//-----------------------------------------------------------------
+bool tb_trace_replay::load_text(FILE *f) {
+  char line[256];
+  int line_no = 0;
+
+  while (fgets(line, sizeof(line), f)) {
+    line_no++;
+
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = 0;
+
+    char cycle[32], id[32], dir[32], addr[32], len[32], burst[32], done[32];
+    int n = sscanf(line, "%31s %31s %31s %31s %31s %31s %31s", cycle, id, dir,
+                   addr, len, burst, done);
+    if (n <= 0)
+      continue;
+    if (n < 6) {
+      printf("ERROR: %s:%d: Expected 'cycle id R|W addr len burst'\n",
+             m_filename.c_str(), line_no);
+      return false;
+    }
+
+    tb_trace_record r;
+    r.cycle = strtoull(cycle, NULL, 0);
+    r.done = (n > 6) ? strtoull(done, NULL, 0) : 0;
+    r.id = strtol(id, NULL, 0);
+    r.write = (dir[0] == 'W' || dir[0] == 'w');
+    r.addr = strtoul(addr, NULL, 0);
+    r.len = strtol(len, NULL, 0);
+    r.burst = parse_burst(burst);
+    m_records.push_back(r);
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------
+// load_binary: Parse binary trace (after the magic)
+//-----------------------------------------------------------------
+bool tb_trace_replay::load_binary(FILE *f) {
+  uint8_t rec[16];
+
+  while (fread(rec, 1, sizeof(rec), f) == sizeof(rec)) {
+    tb_trace_record r;
+
+    r.cycle = 0;
+    for (int i = 7; i >= 0; i--)
+      r.cycle = (r.cycle << 8) | rec[i];
+    r.addr = 0;
+    for (int i = 11; i >= 8; i--)
+      r.addr = (r.addr << 8) | rec[i];
+    r.id = rec[12];
+    r.write = rec[13] != 0;
+    r.len = rec[14];
+    r.burst = rec[15];
+    r.done = 0;
+    m_records.push_back(r);
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------
+// load: Load a text or binary trace file
+//-----------------------------------------------------------------
+bool tb_trace_replay::load(const char *filename) {
+  FILE *f = fopen(filename, "rb");
+  if (!f) {
+    printf("ERROR: Could not open trace %s\n", filename);
+    return false;
+  }
+
+  m_filename = filename;
+  m_records.clear();
+
+  char magic[4];
+  bool ok;
+  if (fread(magic, 1, 4, f) == 4 && !memcmp(magic, TB_TRACE_MAGIC, 4))
+    ok = load_binary(f);
+  else {
+    rewind(f);
+    ok = load_text(f);
+  }
+  fclose(f);
+
+  if (!ok || m_records.empty())
+    return false;
+
+  std::stable_sort(m_records.begin(), m_records.end(), record_order);
+
+  m_first_cycle = m_records.front().cycle;
+  m_trace_span = m_records.back().cycle - m_first_cycle + 1;
+  m_trace_bytes = 0;
+  for (size_t i = 0; i < m_records.size(); i++) {
+    if (m_records[i].done > m_records[i].cycle &&
+        m_records[i].done - m_first_cycle + 1 > m_trace_span)
+      m_trace_span = m_records[i].done - m_first_cycle + 1;
+    m_trace_bytes += (m_records[i].len + 1) * (AXI4_DATA_W / 8);
+  }
+
+  printf("REPLAY: Loaded %d bursts from %s\n", size(), filename);
+  return true;
+}
+//-----------------------------------------------------------------
+// make_txn: Build driver burst for a record
+//-----------------------------------------------------------------
+tb_axi4_txn *tb_trace_replay::make_txn(int idx) {
+  tb_trace_record &r = m_records[idx];
+  uint32_t bytes = (r.len + 1) * (AXI4_DATA_W / 8);
+
+  // Fold into the replay region, keeping the burst inside it
+  uint32_t addr = m_base + ((r.addr % m_size) & ~(AXI4_STRB_W - 1));
+  if ((addr - m_base) + bytes > m_size)
+    addr = m_base;
+
+  tb_axi4_txn *txn =
+      new tb_axi4_txn(r.write, addr, r.id & ((1 << AXI4_ID_W) - 1), r.len,
+                      r.burst);
+  if (r.write)
+    for (int i = 0; i <= r.len; i++)
+      for (int w = 0; w < AXI4_STRB_W / 4; w++)
+        txn->data[i] |= (uint64_t)m_rand.next() << (32 * w);
+
+  txn->user = idx;
+  return txn;
+}
+//-----------------------------------------------------------------
+// retire: Account a completed burst
+//-----------------------------------------------------------------
+void tb_trace_replay::retire(tb_axi4_txn *txn) {
+  tb_trace_record &r = m_records[txn->user];
+  uint64_t due = due_cycle(r.cycle);
+  uint64_t due_done = r.done ? due_cycle(r.done) : due;
+
+  m_issue_slip.add(txn->addr_cycle > due ? txn->addr_cycle - due : 0);
+  m_lateness.add(txn->done_cycle > due_done ? txn->done_cycle - due_done : 0);
+  m_bytes += (txn->len + 1) * (AXI4_DATA_W / 8);
+
+  delete txn;
+}
+//-----------------------------------------------------------------
+// reset_stats: Clear results
+//-----------------------------------------------------------------
+void tb_trace_replay::reset_stats(void) {
+  m_start_cycle = 0;
+  m_end_cycle = 0;
+  m_bytes = 0;
+  m_issue_slip.reset();
+  m_lateness.reset();
+}
+//-----------------------------------------------------------------
+// process: Issue records, retire completions
+//-----------------------------------------------------------------
+void tb_trace_replay::process(void) {
+  while (true) {
+    m_enabled.wait();
+    printf("Starting trace replay (%s)...\n", m_timed ? "timed" : "afap");
+
+    reset_stats();
+    m_start_cycle = m_driver->cycle();
+
+    size_t next = 0;
+    while (next < m_records.size() || m_driver->outstanding() > 0) {
+      while (next < m_records.size()) {
+        if (m_timed && due_cycle(m_records[next].cycle) > m_driver->cycle())
+          break;
+        if (!m_timed && m_driver->outstanding() >= m_max_outstanding)
+          break;
+        m_driver->post(make_txn(next++));
+      }
+
+      m_driver->step();
+
+      tb_axi4_txn *txn;
+      while ((txn = m_driver->completed()) != NULL)
+        retire(txn);
+    }
+
+    m_end_cycle = m_driver->cycle();
+
+    printf("Completed trace replay...\n");
+    m_completed.post();
+  }
+}
+//-----------------------------------------------------------------
+// print_stats: Requested vs achieved bandwidth, lateness
+//-----------------------------------------------------------------
+void tb_trace_replay::print_stats(void) {
+  uint64_t cycles = m_end_cycle - m_start_cycle;
+  double requested = m_trace_span ? (double)m_trace_bytes / m_trace_span : 0;
+  double achieved = cycles ? (double)m_bytes / cycles : 0;
+
+  printf("REPLAY: %s, %d bursts, %s\n", m_filename.c_str(), size(),
+         m_timed ? "timed" : "afap");
+  printf("REPLAY: requested %.3f bytes/cycle over %llu cycles\n", requested,
+         (unsigned long long)m_trace_span);
+  printf("REPLAY: achieved  %.3f bytes/cycle over %llu cycles\n", achieved,
+         (unsigned long long)cycles);
+  m_issue_slip.print("REPLAY: issue slip  ");
+  m_lateness.print("REPLAY: finish late ");
+}
+//-----------------------------------------------------------------
+// write_json: Results as JSON members of the current object
+//-----------------------------------------------------------------
+void tb_trace_replay::write_json(tb_json &js) {
+  uint64_t cycles = m_end_cycle - m_start_cycle;
+
+  js.value("trace", m_filename.c_str());
+  js.value("bursts", (uint32_t)size());
+  js.value("timed", m_timed);
+  js.value("requested_cycles", m_trace_span);
+  js.value("requested_bytes_per_cycle",
+           m_trace_span ? (double)m_trace_bytes / m_trace_span : 0.0);
+  js.value("achieved_cycles", cycles);
+  js.value("achieved_bytes_per_cycle",
+           cycles ? (double)m_bytes / cycles : 0.0);
+  m_issue_slip.write_json(js, "issue_slip");
+  m_lateness.write_json(js, "finish_lateness");
+}
@@ -0,0 +1,123 @@
+#ifndef TB_TRACE_REPLAY_H
+#define TB_TRACE_REPLAY_H
+
+#include "tb_axi4_driver.h"
+#include "tb_histogram.h"
+#include "tb_json.h"
+#include "tb_rand.h"
+#include <string>
+#include <vector>
+
+#define TB_TRACE_MAGIC "AXTR"
+
+//-------------------------------------------------------------
+// tb_trace_record: One recorded AXI burst
+//   Text format (one per line, '#' starts a comment):
+//     <cycle> <id> <R|W> <addr> <axlen> <FIXED|INCR|WRAP|0|1|2> [done]
+//   where the optional [done] is the recorded completion cycle.
+//   Binary format: "AXTR" followed by packed 16 byte records
+//     u64 cycle, u32 addr, u8 id, u8 write, u8 axlen, u8 burst
+//   (little endian).
+//-------------------------------------------------------------
+struct tb_trace_record {
+  uint64_t cycle;
+  uint64_t done; // 0 = not recorded
+  uint32_t addr;
+  int id;
+  bool write;
+  int len;
+  int burst;
+};
+
+//-------------------------------------------------------------
+// tb_trace_replay: Replay a memory trace through tb_axi4_driver
+//-------------------------------------------------------------
+class tb_trace_replay : public sc_module {
+public:
+  //-------------------------------------------------------------
+  // Interface I/O
+  //-------------------------------------------------------------
+  sc_in<bool> clk_in;
+  sc_in<bool> rst_in;
+
+  //-------------------------------------------------------------
+  // Constructor
+  //-------------------------------------------------------------
+  SC_HAS_PROCESS(tb_trace_replay);
+  tb_trace_replay(sc_module_name name, tb_axi4_driver *driver)
+      : sc_module(name), m_enabled("enabled", 0),
+        m_completed("completed", 0) {
+    SC_CTHREAD(process, clk_in.pos());
+    m_driver = driver;
+    m_timed = true;
+    m_max_outstanding = 8;
+    m_base = 0;
+    m_size = 0xFFFFFFFF;
+    m_first_cycle = 0;
+    m_trace_bytes = 0;
+    m_trace_span = 0;
+    m_rand.seed(1, this->name());
+    reset_stats();
+  }
+
+  //-------------------------------------------------------------
+  // API
+  //-------------------------------------------------------------
+  bool load(const char *filename);
+
+  // Honour recorded cycles (true) or issue as fast as possible
+  void set_timed(bool timed) { m_timed = timed; }
+  void set_max_outstanding(int max) { m_max_outstanding = max; }
+  void seed(uint32_t seed) { m_rand.seed(seed, this->name()); }
+
+  // Fold trace addresses into [base, base + size)
+  void set_region(uint32_t base, uint32_t size) {
+    m_base = base;
+    m_size = size;
+  }
+
+  void start(void) { m_enabled.post(); }
+  void wait_complete(void) { m_completed.wait(); }
+
+  int size(void) { return (int)m_records.size(); }
+
+  void print_stats(void);
+  void write_json(tb_json &js);
+
+protected:
+  bool load_text(FILE *f);
+  bool load_binary(FILE *f);
+  uint64_t due_cycle(uint64_t recorded) {
+    return recorded - m_first_cycle + m_start_cycle;
+  }
+  tb_axi4_txn *make_txn(int idx);
+  void retire(tb_axi4_txn *txn);
+  void reset_stats(void);
+  void process(void);
+
+  //-------------------------------------------------------------
+  // Members
+  //-------------------------------------------------------------
+  sc_semaphore m_enabled;
+  sc_semaphore m_completed;
+  tb_axi4_driver *m_driver;
+  std::vector<tb_trace_record> m_records;
+  std::string m_filename;
+  bool m_timed;
+  int m_max_outstanding;
+  uint32_t m_base;
+  uint32_t m_size;
+  tb_rand m_rand;
+
+  // Results
+  uint64_t m_first_cycle;
+  uint64_t m_trace_bytes;
+  uint64_t m_trace_span;
+  uint64_t m_start_cycle;
+  uint64_t m_end_cycle;
+  uint64_t m_bytes;
+  tb_histogram m_issue_slip;
+  tb_histogram m_lateness;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "tb_traffic_pattern.h"
+
+//-----------------------------------------------------------------
+// tb_pattern_random: Uniform random address, length and direction
+//-----------------------------------------------------------------
+class tb_pattern_random : public tb_traffic_pattern {
+public:
+  tb_pattern_random(uint32_t base, uint32_t size, int max_length)
+      : tb_traffic_pattern(base, size, max_length) {}
+
+  const char *name(void) { return "random"; }
+
+  void next(tb_access &acc) {
+    acc.write = pick_write();
+    if (m_rand.bit()) {
+      acc.length = 4;
+      acc.addr = m_base + (m_rand.below(m_size - 4) & ~3);
+    } else {
+      acc.length = 1 + m_rand.below(m_max_length);
+      acc.addr = m_base + m_rand.below(m_size - acc.length);
+    }
+  }
+};
+
+//-----------------------------------------------------------------
+// tb_pattern_sequential: Linear stream of maximum length bursts
+//-----------------------------------------------------------------
+class tb_pattern_sequential : public tb_traffic_pattern {
+public:
+  tb_pattern_sequential(uint32_t base, uint32_t size, int max_length)
+      : tb_traffic_pattern(base, size, max_length) {
+    m_offset = 0;
+  }
+
+  const char *name(void) { return "sequential"; }
+
+  void next(tb_access &acc) {
+    if (m_offset + m_max_length > m_size)
+      m_offset = 0;
+
+    acc.write = pick_write();
+    acc.length = m_max_length;
+    acc.addr = m_base + m_offset;
+
+    m_offset += m_max_length;
+  }
+
+protected:
+  uint32_t m_offset;
+};
+
+//-----------------------------------------------------------------
+// tb_pattern_stride: Word accesses separated by a fixed stride
+//-----------------------------------------------------------------
+class tb_pattern_stride : public tb_traffic_pattern {
+public:
+  tb_pattern_stride(uint32_t base, uint32_t size, int max_length,
+                    uint32_t stride)
+      : tb_traffic_pattern(base, size, max_length) {
+    m_stride = (stride < 4) ? 4 : (stride & ~3);
+    m_offset = 0;
+  }
+
+  const char *name(void) { return "stride"; }
+
+  void next(tb_access &acc) {
+    acc.write = pick_write();
+    acc.length = 4;
+    acc.addr = to_region(m_offset);
+
+    m_offset = (m_offset + m_stride) % m_size;
+  }
+
+protected:
+  uint32_t m_stride;
+  uint32_t m_offset;
+};
+
+//-----------------------------------------------------------------
+// tb_pattern_row_thrash: Every access opens a new row in chip 0,
+// bank 0 (precharge + activate on each access)
+//-----------------------------------------------------------------
+class tb_pattern_row_thrash : public tb_traffic_pattern {
+public:
+  tb_pattern_row_thrash(uint32_t base, uint32_t size, int max_length)
+      : tb_traffic_pattern(base, size, max_length) {
+    m_seq = 0;
+  }
+
+  const char *name(void) { return "row_thrash"; }
+
+  void next(tb_access &acc) {
+    uint32_t row = m_seq % m_rows;
+
+    acc.write = pick_write();
+    acc.length = 4;
+    acc.addr = to_region(
+        tb_sdram_map::encode(0, row, 0, m_seq % tb_sdram_map::cols()));
+    m_seq++;
+  }
+
+protected:
+  uint32_t m_seq;
+};
+
+//-----------------------------------------------------------------
+// tb_pattern_bank_rr: Same row on all banks of chip 0, rotating bank
+// on every access (row hits once all banks are open)
+//-----------------------------------------------------------------
+class tb_pattern_bank_rr : public tb_traffic_pattern {
+public:
+  tb_pattern_bank_rr(uint32_t base, uint32_t size, int max_length)
+      : tb_traffic_pattern(base, size, max_length) {
+    m_seq = 0;
+  }
+
+  const char *name(void) { return "bank_round_robin"; }
+
+  void next(tb_access &acc) {
+    uint32_t bank = m_seq % SDRAM_BANKS;
+    uint32_t col = (m_seq / SDRAM_BANKS) % tb_sdram_map::cols();
+
+    acc.write = pick_write();
+    acc.length = 4;
+    acc.addr = to_region(tb_sdram_map::encode(0, 0, bank, col));
+    m_seq++;
+  }
+
+protected:
+  uint32_t m_seq;
+};
+
+//-----------------------------------------------------------------
+// tb_pattern_chip_hotspot: Random word accesses confined to chip 0
+//-----------------------------------------------------------------
+class tb_pattern_chip_hotspot : public tb_traffic_pattern {
+public:
+  tb_pattern_chip_hotspot(uint32_t base, uint32_t size, int max_length)
+      : tb_traffic_pattern(base, size, max_length) {}
+
+  const char *name(void) { return "chip_hotspot"; }
+
+  void next(tb_access &acc) {
+    uint32_t row = m_rand.below(m_rows);
+    uint32_t bank = m_rand.below(SDRAM_BANKS);
+    uint32_t col = m_rand.below(tb_sdram_map::cols());
+
+    acc.write = pick_write();
+    acc.length = 4;
+    acc.addr = to_region(tb_sdram_map::encode(0, row, bank, col));
+  }
+};
+
+//-----------------------------------------------------------------
+// type_name: Pattern name for a --testcase number
+//-----------------------------------------------------------------
+const char *tb_traffic_pattern::type_name(int type) {
+  switch (type) {
+  case TB_PATTERN_RANDOM:
+    return "random";
+  case TB_PATTERN_SEQUENTIAL:
+    return "sequential";
+  case TB_PATTERN_STRIDE:
+    return "stride";
+  case TB_PATTERN_ROW_THRASH:
+    return "row_thrash";
+  case TB_PATTERN_BANK_ROUND_ROBIN:
+    return "bank_round_robin";
+  case TB_PATTERN_CHIP_HOTSPOT:
+    return "chip_hotspot";
+  default:
+    return "unknown";
+  }
+}
+//-----------------------------------------------------------------
+// create: Pattern factory (base should be aligned to row_span())
+//-----------------------------------------------------------------
+tb_traffic_pattern *tb_traffic_pattern::create(int type, uint32_t base,
+                                               uint32_t size, int max_length,
+                                               uint32_t stride) {
+  switch (type) {
+  case TB_PATTERN_RANDOM:
+    return new tb_pattern_random(base, size, max_length);
+  case TB_PATTERN_SEQUENTIAL:
+    return new tb_pattern_sequential(base, size, max_length);
+  case TB_PATTERN_STRIDE:
+    return new tb_pattern_stride(base, size, max_length, stride);
+  case TB_PATTERN_ROW_THRASH:
+    return new tb_pattern_row_thrash(base, size, max_length);
+  case TB_PATTERN_BANK_ROUND_ROBIN:
+    return new tb_pattern_bank_rr(base, size, max_length);
+  case TB_PATTERN_CHIP_HOTSPOT:
+    return new tb_pattern_chip_hotspot(base, size, max_length);
+  default:
+    return NULL;
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef TB_TRAFFIC_PATTERN_H
+#define TB_TRAFFIC_PATTERN_H
+
+#include "tb_rand.h"
+#include "tb_sdram_map.h"
+#include <stdlib.h>
+
+//--------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------
+enum eTB_PATTERN {
+  TB_PATTERN_RANDOM,
+  TB_PATTERN_SEQUENTIAL,
+  TB_PATTERN_STRIDE,
+  TB_PATTERN_ROW_THRASH,
+  TB_PATTERN_BANK_ROUND_ROBIN,
+  TB_PATTERN_CHIP_HOTSPOT,
+  TB_PATTERN_MAX
+};
+
+//-------------------------------------------------------------
+// tb_access: One generated access
+//-------------------------------------------------------------
+struct tb_access {
+  uint32_t addr;
+  int length;
+  bool write;
+};
+
+//-------------------------------------------------------------
+// tb_traffic_pattern: Address stream generator (base class)
+//-------------------------------------------------------------
+class tb_traffic_pattern {
+public:
+  tb_traffic_pattern(uint32_t base, uint32_t size, int max_length) {
+    m_base = base;
+    m_size = size;
+    m_max_length = max_length;
+    m_write_pct = 50;
+    m_rows = size / tb_sdram_map::row_span();
+    if (m_rows == 0)
+      m_rows = 1;
+  }
+  virtual ~tb_traffic_pattern() {}
+
+  virtual const char *name(void) = 0;
+  virtual void next(tb_access &acc) = 0;
+
+  void set_write_pct(int pct) { m_write_pct = pct; }
+  void seed(uint32_t seed) { m_rand.seed(seed, name()); }
+
+  static tb_traffic_pattern *create(int type, uint32_t base, uint32_t size,
+                                    int max_length, uint32_t stride = 64);
+  static const char *type_name(int type);
+
+protected:
+  bool pick_write(void) { return m_rand.percent(m_write_pct); }
+  uint32_t to_region(uint32_t offset) { return m_base + (offset % m_size); }
+
+protected:
+  uint32_t m_base;
+  uint32_t m_size;
+  uint32_t m_rows;
+  int m_max_length;
+  int m_write_pct;
+  tb_rand m_rand;
+};
+
+#endif
@@ -2,20 +2,38 @@
 #include <cstring>
 #include <systemc.h>
 
+#include "sdram_defines.h"
+#include "tb_json.h"
 #include "tb_mem_test.h"
 #include "tb_memory.h"
+#include "tb_sim_profile.h"
 
 #ifdef BUS_APB
 #include "tb_apb_driver.h"
 #include "sdram_apb.h"
 #else
 #include "tb_axi4_driver.h"
+#include "tb_axi4_interconnect.h"
+#include "tb_axi4_mem_test.h"
+#include "tb_axi4_monitor.h"
+#include "tb_chrome_trace.h"
+#include "tb_coverage.h"
+#include "tb_latency_attrib.h"
+#include "tb_sdram_model.h"
+#include "tb_sdram_monitor.h"
+#include "tb_sdram_power.h"
+#include "tb_sdram_timing.h"
+#include "tb_trace_replay.h"
 #include "sdram_axi.h"
 #endif
 
 #define MEM_BASE 0x00000000
 #define MEM_SIZE (512 * 1024)
 
+#ifndef GIT_HASH
+#define GIT_HASH "unknown"
+#endif
+
 //-----------------------------------------------------------------
 // Module
 //-----------------------------------------------------------------
@@ -23,62 +41,622 @@ class testbench : public testbench_vbase {
 public:
 #ifdef BUS_APB
   tb_apb_driver *m_driver;
+  tb_mem_test *m_sequencer;
   sdram_apb *m_dut;
   sc_signal<apb_master> bus_m;
   sc_signal<apb_slave> bus_s;
 #else
   tb_axi4_driver *m_driver;
+  tb_axi4_mem_test *m_sequencer;
+  tb_axi4_monitor *m_monitor;
+  tb_trace_replay *m_replay;
   sdram_axi *m_dut;
   sc_signal<axi4_master> bus_m;
   sc_signal<axi4_slave> bus_s;
+
+  // SDRAM command bus monitors (one per chip)
+  tb_sdram_monitor *m_sdram_monitor[SDRAM_CHIPS];
+  sc_signal<sdram_io> sdram0;
+  sc_signal<sdram_io> sdram1;
+
+  // Pmem queue occupancy
+  sc_signal<sc_uint<8>> rdata_level;
+  sc_signal<sc_uint<8>> wdata_level;
+  sc_signal<sc_uint<8>> ar_level;
+  sc_signal<sc_uint<8>> aw_level;
+
+  // Timing checker on both command buses
+  tb_sdram_timing *m_timing;
+
+  // Energy estimate over both command buses
+  tb_sdram_power *m_power;
+
+  // --chrome-trace: AXI bursts + SDRAM commands as trace events
+  tb_chrome_trace *m_chrome_trace;
+
+  // Functional coverage (SdramCore states + AXI features)
+  tb_coverage *m_coverage;
+  sc_signal<sdram_core_debug> core0;
+  sc_signal<sdram_core_debug> core1;
+
+  // --latency-threshold: Attribute slow bursts to controller causes
+  tb_latency_attrib *m_latency;
+  sc_signal<sdram_ctrl_debug> ctrl;
+
+  // Benchmark: analytical prediction next to the measurement
+  tb_sdram_model m_model;
+  std::string m_model_file;
+
+  // --sdram-power: IDD table, loaded before traffic starts
+  std::string m_power_file;
+
+  // --coverage: Merged counts, loaded before traffic starts
+  std::string m_coverage_file;
+
+  // --chrome-trace: Output file, opened before traffic starts
+  std::string m_chrome_trace_file;
+
+  // --masters N: drivers 1..N-1 are added behind an interconnect
+  tb_axi4_interconnect *m_interconnect;
+  std::vector<tb_axi4_driver *> m_drivers;
+  std::vector<tb_axi4_mem_test *> m_sequencers;
+  std::vector<tb_axi4_monitor *> m_master_monitors;
+  int m_masters;
+  int m_arb;
+  std::vector<int> m_qos;
 #endif
 
-  tb_mem_test *m_sequencer;
   int m_num_iterations;
+  int m_testcase;
+  uint32_t m_stride;
+  int m_write_pct;
+  int m_max_length;
+  int m_max_outstanding;
+  int m_seed;
+  bool m_delays;
+  std::string m_bench_file;
+  std::string m_replay_file;
+  bool m_replay_afap;
+  tb_sim_profile m_profile;
 
   void set_iterations(int iterations) { m_num_iterations = iterations; }
+  void set_testcase(int tc) { m_testcase = tc; }
+  void set_seed(int seed) {
+    m_seed = seed;
+    m_driver->seed(seed);
+    m_sequencer->seed(seed);
+#ifndef BUS_APB
+    m_replay->seed(seed);
+#endif
+  }
+  void set_delays(bool en) { m_delays = en; }
+  void set_bench(const char *report_file) { m_bench_file = report_file; }
+
+  void set_argcv(int argc, char *argv[]) {
+    for (int i = 0; i < argc - 1; i++) {
+      if (!strcmp(argv[i], "--stride"))
+        m_stride = strtoul(argv[i + 1], NULL, 0);
+      else if (!strcmp(argv[i], "--write-pct"))
+        m_write_pct = strtol(argv[i + 1], NULL, 0);
+      else if (!strcmp(argv[i], "--replay"))
+        m_replay_file = argv[i + 1];
+      else if (!strcmp(argv[i], "--replay-afap"))
+        m_replay_afap = strtol(argv[i + 1], NULL, 0);
+      else if (!strcmp(argv[i], "--outstanding"))
+        m_max_outstanding = strtol(argv[i + 1], NULL, 0);
+      else if (!strcmp(argv[i], "--profile"))
+        tb_sim_profile::set_detail(strtol(argv[i + 1], NULL, 0));
+#ifndef BUS_APB
+      else if (!strcmp(argv[i], "--masters"))
+        m_masters = strtol(argv[i + 1], NULL, 0);
+      else if (!strcmp(argv[i], "--arb"))
+        m_arb = tb_axi4_interconnect::parse_arb(argv[i + 1]);
+      else if (!strcmp(argv[i], "--sdram-profile"))
+        m_timing->set_profile(argv[i + 1]);
+      else if (!strcmp(argv[i], "--chrome-trace"))
+        m_chrome_trace_file = argv[i + 1];
+      else if (!strcmp(argv[i], "--coverage"))
+        m_coverage_file = argv[i + 1];
+      else if (!strcmp(argv[i], "--coverage-plateau"))
+        m_coverage->set_plateau(strtol(argv[i + 1], NULL, 0));
+      else if (!strcmp(argv[i], "--latency-threshold"))
+        m_latency->set_threshold(strtol(argv[i + 1], NULL, 0));
+      else if (!strcmp(argv[i], "--sdram-model"))
+        m_model_file = argv[i + 1];
+      else if (!strcmp(argv[i], "--sdram-power"))
+        m_power_file = argv[i + 1];
+      else if (!strcmp(argv[i], "--timing-fatal"))
+        m_timing->set_fatal(strtol(argv[i + 1], NULL, 0));
+      else if (!strcmp(argv[i], "--qos")) {
+        // Comma separated, one value per master
+        char *p = argv[i + 1];
+        m_qos.clear();
+        while (p) {
+          m_qos.push_back(strtol(p, NULL, 0));
+          p = strchr(p, ',');
+          if (p)
+            p++;
+        }
+      }
+#endif
+    }
+  }
+
+#ifndef BUS_APB
+  //-----------------------------------------------------------------
+  // before_end_of_elaboration: Single driver, or N drivers behind an
+  // interconnect (--masters is only known after construction)
+  //-----------------------------------------------------------------
+  void before_end_of_elaboration(void) {
+    m_drivers.push_back(m_driver);
+    m_sequencers.push_back(m_sequencer);
+
+    if (m_masters <= 1) {
+      m_driver->axi_out(bus_m);
+      m_driver->axi_in(bus_s);
+      return;
+    }
+
+    if (m_masters > TB_AXI4_IC_MAX_MASTERS)
+      m_masters = TB_AXI4_IC_MAX_MASTERS;
+    if (m_arb < 0) {
+      printf("ERROR: Unknown --arb, using round_robin\n");
+      m_arb = TB_ARB_ROUND_ROBIN;
+    }
+
+    m_interconnect = new tb_axi4_interconnect("INTERCONNECT", m_masters);
+    m_interconnect->clk_in(clk);
+    m_interconnect->rst_in(rst);
+    m_interconnect->axi_m_out(bus_m);
+    m_interconnect->axi_s_in(bus_s);
+    m_interconnect->set_arbitration(m_arb);
+
+    for (int i = 0; i < m_masters; i++) {
+      char name[32];
+
+      if (i > 0) {
+        sprintf(name, "DRIVER%d", i);
+        m_drivers.push_back(new tb_axi4_driver(name));
+        m_drivers[i]->seed(m_seed);
+
+        sprintf(name, "SEQ%d", i);
+        m_sequencers.push_back(
+            new tb_axi4_mem_test(name, m_drivers[i], m_max_length));
+        m_sequencers[i]->clk_in(clk);
+        m_sequencers[i]->rst_in(rst);
+        m_sequencers[i]->seed(m_seed);
+      }
+
+      sprintf(name, "bus_m%d", i);
+      sc_signal<axi4_master> *m = new sc_signal<axi4_master>(name);
+      sprintf(name, "bus_s%d", i);
+      sc_signal<axi4_slave> *s = new sc_signal<axi4_slave>(name);
+
+      m_drivers[i]->axi_out(*m);
+      m_drivers[i]->axi_in(*s);
+      m_drivers[i]->set_id_range(0, 1 << m_interconnect->id_width());
+      (*m_interconnect->axi_m_in[i])(*m);
+      (*m_interconnect->axi_s_out[i])(*s);
+
+      if (i < (int)m_qos.size())
+        m_interconnect->set_qos(i, m_qos[i]);
+
+      sprintf(name, "MONITOR%d", i);
+      tb_axi4_monitor *mon = new tb_axi4_monitor(name);
+      mon->clk_in(clk);
+      mon->rst_in(rst);
+      mon->axi_m_in(*m);
+      mon->axi_s_in(*s);
+      m_master_monitors.push_back(mon);
+    }
+  }
+#endif
+
+  //-----------------------------------------------------------------
+  // setup_sequencer: Region, reference model and traffic pattern
+  //-----------------------------------------------------------------
+  bool setup_sequencer(tb_mem_test *seq, int idx, uint32_t base,
+                       uint32_t size) {
+    seq->add_region(base, size);
+    seq->trace_access(true);
+
+    memset(seq->get_array(base), 0, size);
+
+    // --testcase N: SDRAM geometry aware traffic pattern (-1 = random mix)
+    if (m_testcase >= 0) {
+      tb_traffic_pattern *pattern = tb_traffic_pattern::create(
+          m_testcase, base, size, m_max_length, m_stride);
+      if (!pattern) {
+        printf("ERROR: Unknown testcase %d\n", m_testcase);
+        return false;
+      }
+      pattern->set_write_pct(m_write_pct);
+      pattern->seed(m_seed + idx);
+      seq->set_pattern(pattern);
+    }
+
+    return true;
+  }
 
   //-----------------------------------------------------------------
   // process: Drive input sequence
   //-----------------------------------------------------------------
   void process(void) {
+    sc_clock *clock = dynamic_cast<sc_clock *>(clk.get_interface());
+    if (clock)
+      m_profile.set_clock_period(clock->period());
+    m_profile.begin_phase("init");
+
     // reset: do nothing
     wait();
 
-    m_driver->enable_delays(true);
+    // Benchmark: sequential stream by default, no master side stalls
+    bool bench = !m_bench_file.empty();
+    bool replay = !m_replay_file.empty();
+    if (bench && m_testcase < 0 && !replay)
+      m_testcase = TB_PATTERN_SEQUENTIAL;
+
+#ifdef BUS_APB
+    m_driver->enable_delays(m_delays && !bench);
 
-    m_sequencer->add_region(MEM_BASE, MEM_SIZE);
-    m_sequencer->trace_access(true);
+    if (!setup_sequencer(m_sequencer, 0, MEM_BASE, MEM_SIZE)) {
+      sc_stop();
+      return;
+    }
 
-    memset(m_sequencer->get_array(MEM_BASE), 0, MEM_SIZE);
+    if (bench || replay) {
+      printf("ERROR: Benchmark / replay modes require the AXI bus\n");
+      bench = replay = false;
+    }
 
+    // Wait for SDRAM init to complete so the init phase covers it
+    wait(SDRAM_INIT_CYCLES);
+    m_profile.begin_phase("traffic");
     m_sequencer->start(m_num_iterations);
     m_sequencer->wait_complete();
+    m_profile.end();
+#else
+    // Each master gets its own (row aligned) slice of the memory
+    int masters = (int)m_sequencers.size();
+    uint32_t slice = (MEM_SIZE / masters) & ~(tb_sdram_map::row_span() - 1);
+    if (masters == 1)
+      slice = MEM_SIZE;
+
+    for (int i = 0; i < masters; i++) {
+      m_drivers[i]->enable_delays(m_delays && !bench);
+      m_sequencers[i]->set_max_outstanding(m_max_outstanding);
+      if (!setup_sequencer(m_sequencers[i], i, MEM_BASE + (i * slice),
+                           slice)) {
+        sc_stop();
+        return;
+      }
+    }
+
+    m_replay->set_max_outstanding(m_max_outstanding);
+
+    for (int i = 0; i < masters; i++)
+      m_coverage->add_sequencer(m_sequencers[i]);
+
+    if (!m_chrome_trace_file.empty() &&
+        !m_chrome_trace->open(m_chrome_trace_file.c_str())) {
+      sc_stop();
+      return;
+    }
+
+    if (!m_power_file.empty() && !m_power->load(m_power_file.c_str())) {
+      sc_stop();
+      return;
+    }
+
+    if (!m_coverage_file.empty() &&
+        !m_coverage->load(m_coverage_file.c_str())) {
+      sc_stop();
+      return;
+    }
+
+    // Model: pattern defaults first, --sdram-model overrides them
+    if (bench) {
+      if (!replay)
+        m_model.set_pattern(m_testcase, m_max_length, m_stride, m_write_pct);
+      if (!m_model_file.empty() && !m_model.load(m_model_file.c_str())) {
+        sc_stop();
+        return;
+      }
+    }
+
+    if (replay) {
+      if (!m_replay->load(m_replay_file.c_str())) {
+        sc_stop();
+        return;
+      }
+      m_replay->set_region(MEM_BASE, MEM_SIZE);
+      m_replay->set_timed(!m_replay_afap);
+    }
+
+    // Wait for SDRAM init to complete before opening the window, so the
+    // init phase covers it (the driver must only be used from one thread,
+    // so just wait it out)
+    wait(SDRAM_INIT_CYCLES);
+    m_profile.begin_phase("traffic");
+    if (bench) {
+      m_monitor->start();
+      for (int i = 0; i < SDRAM_CHIPS; i++)
+        m_sdram_monitor[i]->start();
+      m_power->start();
+    }
+    for (int i = 0; i < (int)m_master_monitors.size(); i++)
+      m_master_monitors[i]->start();
+
+    if (replay) {
+      m_replay->start();
+      m_replay->wait_complete();
+      m_replay->print_stats();
+    } else {
+      for (int i = 0; i < masters; i++)
+        m_sequencers[i]->start(m_num_iterations);
+      for (int i = 0; i < masters; i++)
+        m_sequencers[i]->wait_complete();
+    }
+    m_profile.end();
+
+    if (masters > 1) {
+      for (int i = 0; i < masters; i++) {
+        m_master_monitors[i]->stop();
+        printf("MASTER %d:\n", i);
+        m_master_monitors[i]->print_stats();
+      }
+      m_interconnect->print_stats();
+    }
+
+    for (int i = 0; i < SDRAM_CHIPS; i++) {
+      m_sdram_monitor[i]->stop();
+      m_sdram_monitor[i]->print_stats();
+    }
+
+    m_power->stop();
+    m_power->print_stats();
+
+    m_timing->finish(m_sdram_monitor[0]->cycle());
+    m_timing->print_stats();
+
+    m_chrome_trace->close();
+
+    m_coverage->print_stats();
+    m_coverage->save();
+
+    m_latency->print_stats();
+
+    if (bench) {
+      m_monitor->stop();
+      m_monitor->print_stats();
+
+      m_model.print_stats(m_monitor);
+
+      write_bench_report();
+    }
+#endif
+    m_profile.print_stats();
     sc_stop();
   }
 
+#ifndef BUS_APB
+  //-----------------------------------------------------------------
+  // write_bench_report: Benchmark results + configuration as JSON
+  //-----------------------------------------------------------------
+  void write_bench_report(void) {
+    FILE *f = fopen(m_bench_file.c_str(), "w");
+    if (!f) {
+      printf("ERROR: Could not open %s\n", m_bench_file.c_str());
+      return;
+    }
+
+    tb_json js(f);
+    js.begin_object();
+    js.value("git_hash", GIT_HASH);
+    js.value("seed", m_seed);
+    if (m_replay_file.empty())
+      js.value("pattern", tb_traffic_pattern::type_name(m_testcase));
+    else
+      js.value("pattern", "replay");
+    js.value("iterations", m_num_iterations);
+    js.value("write_pct", m_write_pct);
+    js.value("stride", m_stride);
+
+    js.begin_object("sdram_params");
+    js.value("mhz", SDRAM_MHZ);
+    js.value("addrW", SDRAM_ADDR_W);
+    js.value("colW", SDRAM_COL_W);
+    js.value("bankW", SDRAM_BANK_W);
+    js.value("dataW", SDRAM_DATA_W);
+    js.value("casLatency", SDRAM_CAS_LATENCY);
+    js.value("tRCD_ns", SDRAM_TRCD_NS);
+    js.value("tRP_ns", SDRAM_TRP_NS);
+    js.value("tRFC_ns", SDRAM_TRFC_NS);
+    js.value("tRAS_ns", SDRAM_TRAS_NS);
+    js.value("tWR_ns", SDRAM_TWR_NS);
+    js.value("tRRD_ns", SDRAM_TRRD_NS);
+    js.value("burstLen", SDRAM_BURST_LEN);
+    js.value("chips", SDRAM_CHIPS);
+    js.value("chipSelBit", SDRAM_CHIP_SEL_BIT);
+    js.value("bankRowCol", SDRAM_BANK_ROW_COL);
+    js.value("bankXor", SDRAM_BANK_XOR);
+    js.value("arQueueDepth", SDRAM_PMEM_AR_DEPTH);
+    js.value("awQueueDepth", SDRAM_PMEM_AW_DEPTH);
+    js.value("readDepth", SDRAM_PMEM_READ_DEPTH);
+    js.value("rwBatch", SDRAM_PMEM_RW_BATCH);
+    js.value("coreQueueDepth", SDRAM_CORE_QUEUE_DEPTH);
+    js.value("refreshPostpone", SDRAM_REFRESH_POSTPONE);
+    js.value("pagePolicy", SDRAM_PAGE_POLICY);
+    js.value("streamDepth", SDRAM_STREAM_DEPTH);
+    js.value("orderDepth", SDRAM_ORDER_DEPTH);
+    js.value("lanes", SDRAM_LANES);
+    js.value("axiDataW", AXI4_DATA_W);
+    js.end_object();
+
+    js.begin_object("results");
+    m_monitor->write_json(js);
+    js.end_object();
+
+    js.begin_array("sdram");
+    for (int i = 0; i < SDRAM_CHIPS; i++) {
+      js.begin_object();
+      m_sdram_monitor[i]->write_json(js);
+      js.end_object();
+    }
+    js.end_array();
+
+    js.begin_object("model");
+    m_model.write_json(js, m_monitor);
+    js.end_object();
+
+    js.begin_object("power");
+    m_power->write_json(js);
+    js.end_object();
+
+    js.begin_object("coverage");
+    m_coverage->write_json(js);
+    js.end_object();
+
+    if (m_latency->enabled()) {
+      js.begin_object("latency_attribution");
+      m_latency->write_json(js);
+      js.end_object();
+    }
+
+    js.begin_object("simulator");
+    m_profile.write_json(js);
+    js.end_object();
+
+    js.begin_object("timing");
+    m_timing->write_json(js);
+    js.end_object();
+
+    if (m_interconnect) {
+      js.value("arbitration", tb_axi4_interconnect::arb_name(m_arb));
+      js.begin_array("masters");
+      for (int i = 0; i < m_interconnect->masters(); i++) {
+        js.begin_object();
+        js.value("master", i);
+        m_master_monitors[i]->write_json(js);
+        js.begin_object("arbitration");
+        m_interconnect->write_json(js, i);
+        js.end_object();
+        js.end_object();
+      }
+      js.end_array();
+    }
+
+    if (!m_replay_file.empty()) {
+      js.begin_object("replay");
+      m_replay->write_json(js);
+      js.end_object();
+    }
+
+    js.end_object();
+    fclose(f);
+
+    printf("BENCH: Report written to %s\n", m_bench_file.c_str());
+  }
+#endif
+
   void init_trace(void) {
     verilator_trace_enable("verilator.vcd", m_dut);
   }
 
   SC_HAS_PROCESS(testbench);
   testbench(sc_module_name name) : testbench_vbase(name) {
+    m_testcase = -1;
+    m_stride = 64;
+    m_write_pct = 50;
+    m_max_outstanding = 8;
+    m_seed = 1;
+    m_delays = true;
+    m_replay_afap = false;
+#ifndef BUS_APB
+    m_interconnect = NULL;
+    m_masters = 1;
+    m_arb = TB_ARB_ROUND_ROBIN;
+#endif
+
 #ifdef BUS_APB
     m_driver = new tb_apb_driver("DRIVER");
     m_driver->apb_out(bus_m);
     m_driver->apb_in(bus_s);
 
-    m_sequencer = new tb_mem_test("SEQ", m_driver, 4);
+    m_max_length = 4;
+    m_sequencer = new tb_mem_test("SEQ", m_driver, m_max_length);
 
     m_dut = new sdram_apb("MEM");
 #else
     m_driver = new tb_axi4_driver("DRIVER");
-    m_driver->axi_out(bus_m);
-    m_driver->axi_in(bus_s);
 
-    m_sequencer = new tb_mem_test("SEQ", m_driver, 32);
+    m_max_length = 32;
+    m_sequencer = new tb_axi4_mem_test("SEQ", m_driver, m_max_length);
 
     m_dut = new sdram_axi("MEM");
+
+    m_monitor = new tb_axi4_monitor("MONITOR");
+    m_monitor->clk_in(clk);
+    m_monitor->rst_in(rst);
+    m_monitor->axi_m_in(bus_m);
+    m_monitor->axi_s_in(bus_s);
+
+    m_replay = new tb_trace_replay("REPLAY", m_driver);
+    m_replay->clk_in(clk);
+    m_replay->rst_in(rst);
+
+    m_dut->sdram0_out(sdram0);
+    m_dut->sdram1_out(sdram1);
+    m_dut->rdata_level_out(rdata_level);
+    m_dut->wdata_level_out(wdata_level);
+    m_dut->ar_level_out(ar_level);
+    m_dut->aw_level_out(aw_level);
+    m_monitor->add_queue("rDataQ", &rdata_level, SDRAM_PMEM_READ_DEPTH);
+    m_monitor->add_queue("wDataQueue", &wdata_level, SDRAM_PMEM_QUEUE_DEPTH);
+    m_monitor->add_queue("arQ", &ar_level,
+                         SDRAM_PMEM_AR_DEPTH ? SDRAM_PMEM_AR_DEPTH : 1);
+    m_monitor->add_queue("awQ", &aw_level,
+                         SDRAM_PMEM_AW_DEPTH ? SDRAM_PMEM_AW_DEPTH : 1);
+
+    m_timing = new tb_sdram_timing();
+    m_power = new tb_sdram_power();
+    m_chrome_trace = new tb_chrome_trace();
+    m_monitor->set_trace(m_chrome_trace);
+
+    m_dut->core0_out(core0);
+    m_dut->core1_out(core1);
+
+    m_coverage = new tb_coverage("COVERAGE");
+    m_coverage->clk_in(clk);
+    m_coverage->rst_in(rst);
+    m_coverage->axi_m_in(bus_m);
+    m_coverage->axi_s_in(bus_s);
+    m_coverage->core_in[0](core0);
+    m_coverage->core_in[1](core1);
+
+    m_dut->ctrl_out(ctrl);
+
+    m_latency = new tb_latency_attrib("LATENCY");
+    m_latency->clk_in(clk);
+    m_latency->rst_in(rst);
+    m_latency->axi_m_in(bus_m);
+    m_latency->axi_s_in(bus_s);
+    m_latency->core_in[0](core0);
+    m_latency->core_in[1](core1);
+    m_latency->ctrl_in(ctrl);
+
+    for (int i = 0; i < SDRAM_CHIPS; i++) {
+      char name[32];
+      sprintf(name, "SDRAM_MONITOR%d", i);
+      m_sdram_monitor[i] = new tb_sdram_monitor(name, i);
+      m_sdram_monitor[i]->clk_in(clk);
+      m_sdram_monitor[i]->rst_in(rst);
+      m_sdram_monitor[i]->sdram_in(i ? sdram1 : sdram0);
+      m_sdram_monitor[i]->add_observer(m_timing);
+      m_sdram_monitor[i]->add_observer(m_power);
+      m_sdram_monitor[i]->add_observer(m_chrome_trace);
+      m_sdram_monitor[i]->add_observer(m_coverage);
+    }
 #endif
     m_sequencer->clk_in(clk);
     m_sequencer->rst_in(rst);
@@ -29,6 +29,8 @@ public:
   virtual void set_testcase(int tc) {}
   virtual void set_delays(bool en) {}
   virtual void set_iterations(int iterations) {}
+  virtual void set_seed(int seed) {}
+  virtual void set_bench(const char *report_file) {}
   virtual void set_argcv(int argc, char *argv[]) {}
 
   virtual void process(void) {
@@ -1,12 +1,25 @@
 package sdram
 
 import chisel3.RawModule
+import java.io.{File, PrintWriter}
 
 object Elaborate extends App {
   val targetDir = if (args.length > 0) args(0) else "build/rtl"
+  // name=N overrides of SdramParams: lanes=2 puts both chips in lock-step
+  // behind a 64-bit AXI port, mhz / cas set the clock and CAS latency
+  def param(name: String, default: Int): Int = args.drop(1).collectFirst {
+    case arg if arg.startsWith(name + "=") => arg.stripPrefix(name + "=").toInt
+  }.getOrElse(default)
+
+  val defaults = SdramParams()
+  val sdramParams = SdramParams(
+    mhz = param("mhz", defaults.mhz),
+    casLatency = param("cas", defaults.casLatency),
+    lanes = param("lanes", defaults.lanes)
+  )
 
   _root_.circt.stage.ChiselStage.emitSystemVerilogFile(
-    new SDRAMAxiSimTop,
+    new SDRAMAxiSimTop(sdramParams),
     args = Array("--target-dir", targetDir),
     firtoolOpts = Array(
       "-O=release",
@@ -15,4 +28,56 @@ object Elaborate extends App {
       "--strip-debug-info"
     )
   )
+
+  ParamsHeader.write(sdramParams, new File(targetDir, "sdram_params.h"))
+}
+
+// The elaborated SdramParams as C++ defines for the testbench
+// (sdram_defines.h / axi4_defines.h), so both sides always agree
+object ParamsHeader {
+  def b(v: Boolean): Int = if (v) 1 else 0
+
+  def write(p: SdramParams, file: File): Unit = {
+    val defines = Seq(
+      "SDRAM_MHZ" -> p.mhz,
+      "SDRAM_ADDR_W" -> p.addrW,
+      "SDRAM_COL_W" -> p.colW,
+      "SDRAM_BANK_W" -> p.bankW,
+      "SDRAM_DATA_W" -> p.dataW,
+      "SDRAM_CAS_LATENCY" -> p.casLatency,
+      "SDRAM_TRCD_NS" -> p.tRCD_ns,
+      "SDRAM_TRP_NS" -> p.tRP_ns,
+      "SDRAM_TRFC_NS" -> p.tRFC_ns,
+      "SDRAM_TRAS_NS" -> p.tRAS_ns,
+      "SDRAM_TWR_NS" -> p.tWR_ns,
+      "SDRAM_TRRD_NS" -> p.tRRD_ns,
+      "SDRAM_BURST_LEN" -> p.burstLen,
+      "SDRAM_CHIP_SEL_BIT" -> p.chipSelBit,
+      "SDRAM_LANES" -> p.lanes,
+      "SDRAM_BANK_ROW_COL" -> b(p.bankRowCol),
+      "SDRAM_BANK_XOR" -> b(p.bankXor),
+      "SDRAM_PMEM_AR_DEPTH" -> p.arQueueDepth,
+      "SDRAM_PMEM_AW_DEPTH" -> p.awQueueDepth,
+      "SDRAM_PMEM_READ_DEPTH" -> p.readDepth,
+      "SDRAM_PMEM_RW_BATCH" -> p.rwBatch,
+      "SDRAM_CORE_QUEUE_DEPTH" -> p.coreQueueDepth,
+      "SDRAM_STREAM_DEPTH" -> p.streamDepth,
+      "SDRAM_ORDER_DEPTH" -> p.orderDepth,
+      "SDRAM_REFRESH_POSTPONE" -> p.refreshPostpone,
+      "SDRAM_PAGE_POLICY" -> p.pagePolicy,
+      "AXI4_DATA_W" -> 8 * p.wordBytes
+    )
+
+    file.getParentFile.mkdirs()
+    val out = new PrintWriter(file)
+    out.println("// Generated by sdram.Elaborate from SdramParams, do not edit")
+    out.println("#ifndef SDRAM_PARAMS_H")
+    out.println("#define SDRAM_PARAMS_H")
+    out.println()
+    for ((name, value) <- defines)
+      out.println(s"#define $name $value")
+    out.println()
+    out.println("#endif")
+    out.close()
+  }
 }
@@ -4,26 +4,47 @@ import chisel3._
 import chisel3.experimental.{Analog, attach}
 import freechips.rocketchip.amba.axi4._
 
-class SDRAMAxi4OnlyInterface extends Bundle {
+class SDRAMAxi4OnlyInterface(dataBits: Int = 32) extends Bundle {
   val clock = Input(Clock())
   val reset = Input(Bool())
-  val in = Flipped(new AXI4Bundle(AXI4BundleParameters(addrBits = 32, dataBits = 32, idBits = 4)))
+  val in = Flipped(new AXI4Bundle(AXI4BundleParameters(addrBits = 32, dataBits = dataBits, idBits = 4)))
+  // Observation only: copy of each chip's command bus for the testbench monitors
+  val sdram0 = Output(new SDRAMIO)
+  val sdram1 = Output(new SDRAMIO)
+  // Observation only: AXI front-end queue occupancy
+  val debug = Output(new PmemDebugIO)
+  // Observation only: SdramCore state per chip
+  val core0 = Output(new CoreDebugIO)
+  val core1 = Output(new CoreDebugIO)
+  val pending = Output(new PendingDebugIO)
 }
 
-class SDRAMAxiSimTop extends FixedIORawModule(new SDRAMAxi4OnlyInterface)
+// lanes = 1: chips interleaved behind a 32-bit AXI port; lanes = 2: both
+// chips in lock-step behind a 64-bit AXI port
+class SDRAMAxiSimTop(sdramParams: SdramParams = SdramParams())
+    extends FixedIORawModule(new SDRAMAxi4OnlyInterface(8 * sdramParams.wordBytes))
     with ImplicitClock with ImplicitReset {
   override protected def implicitClock: Clock = io.clock
   override protected def implicitReset: Reset = io.reset
 
-  val sdramParams = SdramParams()
-
-  val ctrl = Module(new SdramInterleaveTop(sdramParams))
-  val mem0 = Module(new SdramMem(sdramParams))
-  val mem1 = Module(new SdramMem(sdramParams))
+  val axiParams = AXI4BundleParameters(addrBits = 32, dataBits = 8 * sdramParams.wordBytes, idBits = 4)
+  val ctrl = Module(
+    if (sdramParams.lanes > 1) new SdramLockStepTop(sdramParams, axiParams)
+    else new SdramInterleaveTop(sdramParams, axiParams)
+  )
+  val mem0 = Module(new SdramMem(sdramParams.chip))
+  val mem1 = Module(new SdramMem(sdramParams.chip))
 
   ctrl.io.axi <> io.in
   mem0.io <> ctrl.io.sdram0
   attach(ctrl.sdram_dq0, mem0.sdram_dq)
   mem1.io <> ctrl.io.sdram1
   attach(ctrl.sdram_dq1, mem1.sdram_dq)
+
+  io.sdram0 := ctrl.io.sdram0
+  io.sdram1 := ctrl.io.sdram1
+  io.debug := ctrl.io.debug
+  io.core0 := ctrl.io.core0
+  io.core1 := ctrl.io.core1
+  io.pending := ctrl.io.pending
 }
@@ -14,21 +14,89 @@ case class SdramParams(
   colW: Int = 9,
   bankW: Int = 2,
   dataW: Int = 16,
+  // CAS latency programmed in the mode register (3 above ~100 MHz)
   casLatency: Int = 2,
   tRCD_ns: Int = 20,
   tRP_ns: Int = 20,
-  tRFC_ns: Int = 60
+  tRFC_ns: Int = 60,
+  tRAS_ns: Int = 42,
+  tWR_ns: Int = 12,
+  tRRD_ns: Int = 12,
+  // Mode register burst length (2, 4 or 8 beats); consecutive words in
+  // one BL block stream without a new READ / WRITE
+  burstLen: Int = 8,
+  // Controller: read / write bursts queued in SdramAxiPmem (0 = one at a time)
+  arQueueDepth: Int = 2,
+  awQueueDepth: Int = 2,
+  // Controller: read words in flight (R data buffer); 0 = enough for a
+  // word per cycle (casLatency + 6, see readDepth)
+  rDataDepth: Int = 0,
+  // Controller: same direction requests issued before yielding to the
+  // other direction (0 = alternate per request)
+  rwBatch: Int = 16,
+  // Core: requests queued in SdramCore; the bank scheduler opens the
+  // rows of queued requests while the current one is served
+  coreQueueDepth: Int = 2,
+  // Core address bit order: row | bank | col (false) or bank | row | col
+  bankRowCol: Boolean = false,
+  // Bank = bank bits XOR low row bits, spreads same bank row conflicts
+  bankXor: Boolean = false,
+  // SdramInterleaveTop: AXI address bit selecting the chip
+  // (2 = word, 4 = 16 byte burst, 5 = 32 byte line interleave)
+  chipSelBit: Int = 2,
+  // Chips one SdramCore drives in lock-step: 1 = a core per chip behind
+  // SdramInterleaveTop, 2 = both chips as one 2 x dataW device behind
+  // SdramLockStepTop (64-bit AXI)
+  lanes: Int = 1,
+  // SdramInterleaveTop: requests buffered per chip, so each chip drains
+  // its own stream while the front-end fills the other
+  streamDepth: Int = 4,
+  // Requests in flight over both chips (SdramInterleaveTop response
+  // reorder queue); also caps the writes SdramAxiPmem has in flight
+  orderDepth: Int = 16,
+  // Refreshes owed before one is forced (JEDEC: up to 8); owed ones are
+  // caught up while the core has no requests (0 = refresh when due)
+  refreshPostpone: Int = 8,
+  // Rows no queued request hits: 0 = leave open, 1 = close (precharge
+  // in a spare command slot), 2 = adaptive (close banks whose recent
+  // accesses mostly changed row)
+  pagePolicy: Int = 2
 ) {
+  require(chipSelBit >= 2 && chipSelBit <= colW + 1,
+    "chipSelBit must select within a row (2 .. colW + 1)")
+  require(refreshPostpone >= 0 && refreshPostpone <= 8,
+    "refreshPostpone must be 0 .. 8")
+  require(pagePolicy >= 0 && pagePolicy <= 2, "pagePolicy must be 0, 1 or 2")
+  require(streamDepth >= 1, "streamDepth must be at least 1")
+  require(orderDepth >= 2 * (streamDepth + coreQueueDepth.max(1)),
+    "orderDepth must cover both chips' stream and core queues")
+  require(lanes == 1 || lanes == 2, "lanes must be 1 or 2")
+  require(casLatency == 2 || casLatency == 3, "casLatency must be 2 or 3")
+  require(rDataDepth >= 0 && rDataDepth < 256, "rDataDepth must be 0 .. 255")
+
   val dqmW = dataW / 8
   val rowW = addrW - colW - bankW
   val banks = 1 << bankW
   val refreshCnt = 1 << rowW
-  val startDelay = 100000 / (1000 / mhz)
+  // Clocks covering ns, rounded up (exact for periods that are not a
+  // whole number of ns, 7.5 ns at 133 MHz)
+  def cycles(ns: Int): Int = (ns * mhz + 999) / 1000
+  val startDelay = 100 * mhz // 100 us
   val refreshCycles = (64000 * mhz) / refreshCnt - 1
-  val cycleTimeNs = 1000 / mhz
-  val trcdCycles = (tRCD_ns + (cycleTimeNs - 1)) / cycleTimeNs
-  val trpCycles = (tRP_ns + (cycleTimeNs - 1)) / cycleTimeNs
-  val trfcCycles = (tRFC_ns + (cycleTimeNs - 1)) / cycleTimeNs
+  val trcdCycles = cycles(tRCD_ns)
+  val trpCycles = cycles(tRP_ns)
+  val trfcCycles = cycles(tRFC_ns)
+  val trasCycles = cycles(tRAS_ns)
+  val twrCycles = cycles(tWR_ns)
+  val trrdCycles = cycles(tRRD_ns)
+  // Read words SdramAxiPmem keeps in flight. Grant to R takes
+  // casLatency + 5 cycles, and a slot only frees the cycle after the R
+  // handshake, so each word holds one for casLatency + 6 cycles.
+  val readDepth = if (rDataDepth > 0) rDataDepth else casLatency + 6
+  // Core word: two beats of every lane
+  val wordBytes = 2 * dataW * lanes / 8
+  // One chip of the device
+  def chip: SdramParams = copy(lanes = 1)
 }
 
 class SDRAMIO(val p: SdramParams = SdramParams()) extends Bundle {
@@ -40,7 +108,14 @@ class SDRAMIO(val p: SdramParams = SdramParams()) extends Bundle {
   val we = Output(Bool())
   val addr = Output(UInt(p.rowW.W))
   val ba = Output(UInt(p.bankW.W))
-  val dqm = Output(UInt(p.dqmW.W))
+  val dqm = Output(UInt((p.dqmW * p.lanes).W))
+}
+
+// Response reorder head (oldest outstanding request), for the
+// testbench monitors
+class PendingDebugIO extends Bundle {
+  val valid = Bool()
+  val chip = Bool()
 }
 
 class SdramAxiTop(
@@ -51,7 +126,7 @@ class SdramAxiTop(
     val axi = Flipped(new AXI4Bundle(axiParams))
     val sdram = new SDRAMIO(sdramParams)
   })
-  val pmem = Module(new SdramAxiPmem(axiParams))
+  val pmem = Module(new SdramAxiPmem(axiParams, sdramParams))
   val core = Module(new SdramCore(sdramParams))
 
   pmem.io.axi <> io.axi
@@ -71,65 +146,121 @@ class SdramAxiTop(
   attach(sdram_dq, core.sdram_dq)
 }
 
-class SdramInterleaveTop(
-  sdramParams: SdramParams = SdramParams(),
-  axiParams: AXI4BundleParameters = AXI4BundleParameters(addrBits = 32, dataBits = 32, idBits = 4)
+// Two chip controller: AXI in, a command bus and data bus per chip
+abstract class SdramDualTop(
+  sdramParams: SdramParams,
+  axiParams: AXI4BundleParameters
 ) extends Module {
   val io = IO(new Bundle {
     val axi = Flipped(new AXI4Bundle(axiParams))
-    val sdram0 = new SDRAMIO(sdramParams)
-    val sdram1 = new SDRAMIO(sdramParams)
+    val sdram0 = new SDRAMIO(sdramParams.chip)
+    val sdram1 = new SDRAMIO(sdramParams.chip)
+    val debug = Output(new PmemDebugIO)
+    val core0 = Output(new CoreDebugIO)
+    val core1 = Output(new CoreDebugIO)
+    val pending = Output(new PendingDebugIO)
   })
   val sdram_dq0 = IO(Analog(sdramParams.dataW.W))
   val sdram_dq1 = IO(Analog(sdramParams.dataW.W))
+}
+
+class SdramInterleaveTop(
+  sdramParams: SdramParams = SdramParams(),
+  axiParams: AXI4BundleParameters = AXI4BundleParameters(addrBits = 32, dataBits = 32, idBits = 4)
+) extends SdramDualTop(sdramParams, axiParams) {
+  require(sdramParams.lanes == 1, "SdramInterleaveTop drives one chip per core")
 
-  val pmem = Module(new SdramAxiPmem(axiParams))
+  val pmem = Module(new SdramAxiPmem(axiParams, sdramParams))
   val core0 = Module(new SdramCore(sdramParams))
   val core1 = Module(new SdramCore(sdramParams))
 
   pmem.io.axi <> io.axi
+  io.debug := pmem.io.debug
 
   // --- Interleave routing ---
-  // addr(2) indicate the word-address
-  val chipSel = pmem.io.ram.addr(2)
-  // sdram is byte-addressable
+  // addr(chipSelBit) picks the chip: word, burst or line granularity
+  val CHIP_SEL = sdramParams.chipSelBit
+  val chipSel = pmem.io.ram.addr(CHIP_SEL)
+  // sdram is byte-addressable; the chip bit is squeezed out
   val coreAddr = Cat(
     0.U((32 - sdramParams.addrW - 1).W),
-    pmem.io.ram.addr(sdramParams.addrW + 1, 3),
-    pmem.io.ram.addr(1, 0)
+    pmem.io.ram.addr(sdramParams.addrW + 1, CHIP_SEL + 1),
+    pmem.io.ram.addr(CHIP_SEL - 1, 0)
   )
 
-  // Request routing: gate rd/wstrb so only the target core sees a request
-  core0.io.inportAddr := coreAddr
-  core0.io.inportRd := pmem.io.ram.rd && !chipSel
-  core0.io.inportWr := Mux(!chipSel, pmem.io.ram.wstrb, 0.U)
-  core0.io.inportWriteData := pmem.io.ram.writeData
-  core0.io.inportLen := pmem.io.ram.len
+  // Per chip request streams: the front-end issues one request per
+  // cycle into the target chip's stream, and both cores drain theirs
+  // in parallel, so one chip no longer waits on the other's accept
+  class StreamReq extends Bundle {
+    val addr = UInt(32.W)
+    val wr = UInt(4.W)
+    val rd = Bool()
+    val len = UInt(8.W)
+    val data = UInt(32.W)
+  }
+  val cores = Seq(core0, core1)
+  val streamQ = cores.map { _ =>
+    Module(new Queue(new StreamReq, sdramParams.streamDepth))
+  }
 
-  core1.io.inportAddr := coreAddr
-  core1.io.inportRd := pmem.io.ram.rd && chipSel
-  core1.io.inportWr := Mux(chipSel, pmem.io.ram.wstrb, 0.U)
-  core1.io.inportWriteData := pmem.io.ram.writeData
-  core1.io.inportLen := pmem.io.ram.len
+  // Reorder: acks return in issue order, buffered per core until due.
+  // ORDER_DEPTH bounds the requests in flight over both chips.
+  val ORDER_DEPTH = sdramParams.orderDepth
+  val orderQ = Module(new Queue(Bool(), ORDER_DEPTH))
+  val reqActive = pmem.io.ram.rd || pmem.io.ram.wstrb =/= 0.U
+  val streamRoom = Mux(chipSel, streamQ(1).io.enq.ready, streamQ(0).io.enq.ready)
 
-  // Accept from the targeted core
-  pmem.io.ram.accept := Mux(chipSel, core1.io.inportAccept, core0.io.inportAccept)
+  pmem.io.ram.accept := reqActive && streamRoom && orderQ.io.enq.ready
+  orderQ.io.enq.valid := pmem.io.ram.accept
+  orderQ.io.enq.bits := chipSel
 
-  // Pending FIFO: track which core each accepted request went to
-  val pendingQ = Module(new Queue(Bool(), 4))
-  val reqActive = pmem.io.ram.rd || pmem.io.ram.wstrb =/= 0.U
-  pendingQ.io.enq.valid := pmem.io.ram.accept && reqActive
-  pendingQ.io.enq.bits := chipSel
+  for ((core, c) <- cores.zipWithIndex) {
+    val q = streamQ(c)
+    q.io.enq.valid := pmem.io.ram.accept && chipSel === c.U
+    q.io.enq.bits.addr := coreAddr
+    q.io.enq.bits.wr := pmem.io.ram.wstrb
+    q.io.enq.bits.rd := pmem.io.ram.rd
+    q.io.enq.bits.len := pmem.io.ram.len
+    q.io.enq.bits.data := pmem.io.ram.writeData
+
+    core.io.inportAddr := q.io.deq.bits.addr
+    core.io.inportRd := q.io.deq.valid && q.io.deq.bits.rd
+    core.io.inportWr := Mux(q.io.deq.valid, q.io.deq.bits.wr, 0.U)
+    core.io.inportWriteData := q.io.deq.bits.data
+    core.io.inportLen := q.io.deq.bits.len
+    q.io.deq.ready := core.io.inportAccept
+  }
+
+  class AckEntry extends Bundle {
+    val data = UInt(32.W)
+    val error = Bool()
+  }
+  val ackQ = cores.map { core =>
+    val q = Module(new Queue(new AckEntry, ORDER_DEPTH, flow = true))
+    q.io.enq.valid := core.io.inportAck
+    q.io.enq.bits.data := core.io.inportReadData
+    q.io.enq.bits.error := core.io.inportError
+    // Never more acks than requests in flight
+    assert(!core.io.inportAck || q.io.enq.ready)
+    q
+  }
+
+  val ackCore = orderQ.io.deq.bits
+  val routedAck = Mux(ackCore, ackQ(1).io.deq.valid, ackQ(0).io.deq.valid)
+  val routedEntry = Mux(ackCore, ackQ(1).io.deq.bits, ackQ(0).io.deq.bits)
 
-  val ackCore = pendingQ.io.deq.bits
-  val core0Ack = core0.io.inportAck
-  val core1Ack = core1.io.inportAck
-  val routedAck = Mux(ackCore, core1Ack, core0Ack)
+  pmem.io.ram.ack := routedAck && orderQ.io.deq.valid
+  pmem.io.ram.readData := routedEntry.data
+  pmem.io.ram.error := routedEntry.error
+  orderQ.io.deq.ready := pmem.io.ram.ack
+  ackQ(0).io.deq.ready := pmem.io.ram.ack && !ackCore
+  ackQ(1).io.deq.ready := pmem.io.ram.ack && ackCore
 
-  pmem.io.ram.ack := routedAck && pendingQ.io.deq.valid
-  pmem.io.ram.readData := Mux(ackCore, core1.io.inportReadData, core0.io.inportReadData)
-  pmem.io.ram.error := Mux(ackCore, core1.io.inportError, core0.io.inportError)
-  pendingQ.io.deq.ready := routedAck && pendingQ.io.deq.valid
+  io.pending.valid := orderQ.io.deq.valid
+  io.pending.chip := orderQ.io.deq.bits
+
+  io.core0 := core0.io.debug
+  io.core1 := core1.io.debug
 
   // SDRAM IO
   io.sdram0 <> core0.io.sdram
@@ -138,8 +269,58 @@ class SdramInterleaveTop(
   attach(sdram_dq1, core1.sdram_dq)
 }
 
+// One SdramCore drives both chips in lock-step as a single 2 x dataW
+// device: the command bus is shared, each chip gets its own dqm and data
+// lane. A core word (two beats) is one 64-bit AXI beat.
+class SdramLockStepTop(
+  sdramParams: SdramParams = SdramParams(lanes = 2),
+  axiParams: AXI4BundleParameters = AXI4BundleParameters(addrBits = 32, dataBits = 64, idBits = 4)
+) extends SdramDualTop(sdramParams, axiParams) {
+  require(sdramParams.lanes == 2, "SdramLockStepTop drives two lanes")
+  require(axiParams.dataBits == 8 * sdramParams.wordBytes,
+    "AXI data width must match the core word")
+
+  val pmem = Module(new SdramAxiPmem(axiParams, sdramParams))
+  val core = Module(new SdramCore(sdramParams))
+
+  pmem.io.axi <> io.axi
+  io.debug := pmem.io.debug
+
+  core.io.inportWr := pmem.io.ram.wstrb
+  core.io.inportRd := pmem.io.ram.rd
+  core.io.inportLen := pmem.io.ram.len
+  core.io.inportAddr := pmem.io.ram.addr
+  core.io.inportWriteData := pmem.io.ram.writeData
+  pmem.io.ram.accept := core.io.inportAccept
+  pmem.io.ram.ack := core.io.inportAck
+  pmem.io.ram.error := core.io.inportError
+  pmem.io.ram.readData := core.io.inportReadData
+
+  // Same command to both chips, the core's dqm split per lane
+  val DQM_W = sdramParams.dqmW
+  for ((chip, lane) <- Seq(io.sdram0, io.sdram1).zipWithIndex) {
+    chip.clk := core.io.sdram.clk
+    chip.cke := core.io.sdram.cke
+    chip.cs := core.io.sdram.cs
+    chip.ras := core.io.sdram.ras
+    chip.cas := core.io.sdram.cas
+    chip.we := core.io.sdram.we
+    chip.addr := core.io.sdram.addr
+    chip.ba := core.io.sdram.ba
+    chip.dqm := core.io.sdram.dqm(DQM_W * (lane + 1) - 1, DQM_W * lane)
+  }
+  attach(sdram_dq0, core.sdram_dq)
+  attach(sdram_dq1, core.sdram_dq_hi.get)
+
+  // Both chips run the one core's state machine
+  io.core0 := core.io.debug
+  io.core1 := core.io.debug
+  io.pending.valid := false.B
+  io.pending.chip := false.B
+}
+
 class AXI4SDRAM(address: Seq[AddressSet], sdramParams: SdramParams = SdramParams())(implicit p: Parameters) extends LazyModule {
-  val beatBytes = 4
+  val beatBytes = sdramParams.wordBytes
   val node = AXI4SlaveNode(
     Seq(
       AXI4SlavePortParameters(
@@ -161,11 +342,14 @@ class AXI4SDRAM(address: Seq[AddressSet], sdramParams: SdramParams = SdramParams
 
   class Impl extends LazyModuleImp(this) {
     val (in, edge) = node.in(0)
-    val sdram_bundle0 = IO(new SDRAMIO(sdramParams))
+    val sdram_bundle0 = IO(new SDRAMIO(sdramParams.chip))
     val sdram_dq0 = IO(Analog(sdramParams.dataW.W))
-    val sdram_bundle1 = IO(new SDRAMIO(sdramParams))
+    val sdram_bundle1 = IO(new SDRAMIO(sdramParams.chip))
     val sdram_dq1 = IO(Analog(sdramParams.dataW.W))
-    val ctrl = Module(new SdramInterleaveTop(sdramParams, edge.bundle))
+    val ctrl = Module(
+      if (sdramParams.lanes > 1) new SdramLockStepTop(sdramParams, edge.bundle)
+      else new SdramInterleaveTop(sdramParams, edge.bundle)
+    )
     ctrl.io.axi <> in
     sdram_bundle0 <> ctrl.io.sdram0
     sdram_bundle1 <> ctrl.io.sdram1
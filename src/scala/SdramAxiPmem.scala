@@ -4,16 +4,29 @@ import chisel3._
 import chisel3.util._
 import freechips.rocketchip.amba.axi4._
 
-class RamIO extends Bundle {
-  val wstrb = Output(UInt(4.W))
+class RamIO(dataBits: Int = 32) extends Bundle {
+  val wstrb = Output(UInt((dataBits / 8).W))
   val rd = Output(Bool())
   val len = Output(UInt(8.W))
   val addr = Output(UInt(32.W))
-  val writeData = Output(UInt(32.W))
+  val writeData = Output(UInt(dataBits.W))
   val accept = Input(Bool())
   val ack = Input(Bool())
   val error = Input(Bool())
-  val readData = Input(UInt(32.W))
+  val readData = Input(UInt(dataBits.W))
+}
+
+// Queue occupancy, for the testbench monitors
+class PmemDebugIO extends Bundle {
+  val rDataCount = UInt(8.W)
+  val wDataCount = UInt(8.W)
+  val arCount = UInt(8.W)
+  val awCount = UInt(8.W)
+  // Request waiting: other direction granted / other direction acks pending
+  val rArbLoss = Bool()
+  val wArbLoss = Bool()
+  val rTurnaround = Bool()
+  val wTurnaround = Bool()
 }
 
 class WDataEntry(dataBits: Int) extends Bundle {
@@ -21,85 +34,158 @@ class WDataEntry(dataBits: Int) extends Bundle {
   val strb = UInt((dataBits / 8).W)
 }
 
+class AxEntry(addrBits: Int, idBits: Int) extends Bundle {
+  val addr = UInt(addrBits.W)
+  val id = UInt(idBits.W)
+  val burst = UInt(2.W)
+  val len = UInt(8.W)
+}
+
+class RespEntry(idBits: Int) extends Bundle {
+  val id = UInt(idBits.W)
+  val len = UInt(8.W)
+}
+
 class SdramAxiPmem(
     axiParams: AXI4BundleParameters =
-      AXI4BundleParameters(addrBits = 32, dataBits = 32, idBits = 4)
+      AXI4BundleParameters(addrBits = 32, dataBits = 32, idBits = 4),
+    p: SdramParams = SdramParams()
 ) extends Module {
   val io = IO(new Bundle {
     val axi = Flipped(new AXI4Bundle(axiParams))
-    val ram = new RamIO
+    val ram = new RamIO(axiParams.dataBits)
+    val debug = Output(new PmemDebugIO)
   })
 
   val QUEUE_DEPTH = 4
+  // Read words in flight: grant to R takes CL + 5 cycles, and
+  // rOutstanding only drops the cycle after the R handshake, so fewer
+  // than CL + 6 would drain the CAS pipeline between words
+  val R_DEPTH = p.readDepth
+  val R_COUNT_W = log2Ceil(R_DEPTH + 1)
+  // Write words in flight (acks pending), as many as the top can order
+  val W_DEPTH = p.orderDepth
+  val W_COUNT_W = log2Ceil(W_DEPTH + 1)
+  // 0: accept the next AR / AW only once the previous burst has completed
+  val AR_DEPTH = p.arQueueDepth
+  val AW_DEPTH = p.awQueueDepth
+  // Same direction requests before yielding (0: round robin per request)
+  val RW_BATCH = p.rwBatch
+
+  // One ram request per AXI beat
+  val BEAT_BYTES = axiParams.dataBits / 8
 
   def calculateAddrNext(addr: UInt, axtype: UInt, axlen: UInt): UInt = {
-    val result = WireDefault(addr + 4.U)
+    val result = WireDefault(addr + BEAT_BYTES.U)
     val mask = WireDefault(0.U(32.W))
     switch(axtype) {
       is(0.U) { result := addr }
       is(2.U) {
+        // Wrap boundary: (len + 1) beats
         switch(axlen) {
-          is(0.U) { mask := "h03".U }
-          is(1.U) { mask := "h07".U }
-          is(3.U) { mask := "h0F".U }
-          is(7.U) { mask := "h1F".U }
-          is(15.U) { mask := "h3F".U }
+          is(0.U) { mask := (BEAT_BYTES - 1).U }
+          is(1.U) { mask := (2 * BEAT_BYTES - 1).U }
+          is(3.U) { mask := (4 * BEAT_BYTES - 1).U }
+          is(7.U) { mask := (8 * BEAT_BYTES - 1).U }
+          is(15.U) { mask := (16 * BEAT_BYTES - 1).U }
         }
-        result := (addr & ~mask) | ((addr + 4.U) & mask)
+        result := (addr & ~mask) | ((addr + BEAT_BYTES.U) & mask)
       }
     }
     result
   }
 
   // ==================== Read FSM ====================
-  object RState extends ChiselEnum {
-    val rIdle, rBurst = Value
-  }
+  // Issue side: walks the burst at the head of arQ, loading the next
+  // one in the same cycle the last request is accepted. Response side:
+  // rRespQ holds the ID / length of each issued burst, so R data (which
+  // returns in issue order) is tagged in order behind it.
+  val arQ = Module(
+    new Queue(new AxEntry(axiParams.addrBits, axiParams.idBits), AR_DEPTH.max(1), flow = true)
+  )
+  // A burst per word in flight at most
+  val rRespQ = Module(new Queue(new RespEntry(axiParams.idBits), R_DEPTH))
 
-  val rState = RegInit(RState.rIdle)
   val rAddr = Reg(UInt(32.W))
-  val rId = Reg(UInt(axiParams.idBits.W))
   val rBurstType = Reg(UInt(2.W))
   val rBurstLen = Reg(UInt(8.W))
   val rReqCnt = Reg(UInt(8.W))
-  val rRespCnt = Reg(UInt(8.W))
+  val rRespCnt = RegInit(0.U(8.W))
   val rAllReqsSent = RegInit(true.B)
 
-  val rDataQ = Module(new Queue(UInt(axiParams.dataBits.W), QUEUE_DEPTH))
+  val rDataQ = Module(new Queue(UInt(axiParams.dataBits.W), R_DEPTH))
 
   // ==================== Write FSM ====================
-  object WState extends ChiselEnum {
-    val wIdle, wBurst, wResp = Value
-  }
+  // Same split as reads: awQ feeds the issue side, wRespQ holds the ID /
+  // length of each issued burst until all of its acks are back.
+  val awQ = Module(
+    new Queue(new AxEntry(axiParams.addrBits, axiParams.idBits), AW_DEPTH.max(1), flow = true)
+  )
+  val wRespQ = Module(new Queue(new RespEntry(axiParams.idBits), QUEUE_DEPTH))
 
-  val wState = RegInit(WState.wIdle)
   val wAddr = Reg(UInt(32.W))
-  val wId = Reg(UInt(axiParams.idBits.W))
   val wBurstType = Reg(UInt(2.W))
   val wBurstLen = Reg(UInt(8.W))
   val wReqCnt = Reg(UInt(8.W))
   val wAllReqsSent = RegInit(true.B)
+  val wAcked = RegInit(0.U(11.W))
 
   val wDataQueue = Module(new Queue(new WDataEntry(axiParams.dataBits), QUEUE_DEPTH))
 
   // ==================== Ack Pending & Flow Control ====================
-  val rAckPending = RegInit(0.U(4.W))
-  val wAckPending = RegInit(0.U(4.W))
-  val rOutstanding = RegInit(0.U(4.W))
+  val rAckPending = RegInit(0.U(R_COUNT_W.W))
+  val wAckPending = RegInit(0.U(W_COUNT_W.W))
+  val rOutstanding = RegInit(0.U(R_COUNT_W.W))
 
   // ==================== Arbiter ====================
-  val rReqRam = rState === RState.rBurst && !rAllReqsSent && rOutstanding < QUEUE_DEPTH.U
-  val wReqRam = wState === WState.wBurst && !wAllReqsSent && wDataQueue.io.deq.valid
+  // Acks carry no direction, so a direction only issues once the other
+  // one's acks have drained (the turnaround). The scheduler keeps issuing
+  // in the current direction while it has work, up to RW_BATCH requests
+  // when the other direction is waiting, to make turnarounds rare.
+  val rReqRam = !rAllReqsSent && rOutstanding < R_DEPTH.U
+  val wReqRam = !wAllReqsSent && wDataQueue.io.deq.valid && wAckPending < W_DEPTH.U
+
+  val grantRead = Wire(Bool())
+  val grantWrite = Wire(Bool())
+
+  if (RW_BATCH == 0) {
+    val arbiter = Module(new RRArbiter(Bool(), 2))
+    arbiter.io.in(0).valid := rReqRam && wAckPending === 0.U
+    arbiter.io.in(0).bits := DontCare
+    arbiter.io.in(1).valid := wReqRam && rAckPending === 0.U
+    arbiter.io.in(1).bits := DontCare
+    arbiter.io.out.ready := io.ram.accept
+
+    grantRead := arbiter.io.out.valid && arbiter.io.chosen === 0.U
+    grantWrite := arbiter.io.out.valid && arbiter.io.chosen === 1.U
+  } else {
+    val dirWriteQ = RegInit(false.B)
+    val batchQ = RegInit(0.U(8.W))
 
-  val arbiter = Module(new RRArbiter(Bool(), 2))
-  arbiter.io.in(0).valid := rReqRam && wAckPending === 0.U
-  arbiter.io.in(0).bits := DontCare
-  arbiter.io.in(1).valid := wReqRam && rAckPending === 0.U
-  arbiter.io.in(1).bits := DontCare
-  arbiter.io.out.ready := io.ram.accept
+    // A read burst holds the direction while its acks are in flight (the
+    // outstanding limit frees up without the master), a write burst
+    // while its data is there (the in flight cap frees up the same way)
+    val rWork = rReqRam || (!rAllReqsSent && rAckPending =/= 0.U)
+    val wWork = !wAllReqsSent && wDataQueue.io.deq.valid
+    val curWork = Mux(dirWriteQ, wWork, rWork)
+    val otherWork = Mux(dirWriteQ, rWork, wWork)
+    // Never withdraw a presented request: the core may already be on its
+    // way to the READ / WRITE slot for it
+    val holdQ = RegNext((grantRead || grantWrite) && !io.ram.accept, false.B)
+    val switchDir = !holdQ && otherWork && (!curWork || batchQ >= RW_BATCH.U)
+    val dirWrite = dirWriteQ =/= switchDir
 
-  val grantRead = arbiter.io.out.valid && arbiter.io.chosen === 0.U
-  val grantWrite = arbiter.io.out.valid && arbiter.io.chosen === 1.U
+    grantRead := !dirWrite && rReqRam && wAckPending === 0.U
+    grantWrite := dirWrite && wReqRam && rAckPending === 0.U
+
+    val issued = (grantRead || grantWrite) && io.ram.accept
+    dirWriteQ := dirWrite
+    when(switchDir) {
+      batchQ := issued.asUInt
+    }.elsewhen(issued && batchQ =/= 255.U) {
+      batchQ := batchQ + 1.U
+    }
+  }
 
   // ==================== Ack Routing ====================
   val ackToRead = io.ram.ack && rAckPending > 0.U
@@ -131,97 +217,110 @@ class SdramAxiPmem(
   // ==================== Read Data Queue ====================
   rDataQ.io.enq.valid := ackToRead
   rDataQ.io.enq.bits := io.ram.readData
-  rDataQ.io.deq.ready := io.axi.r.ready && rState === RState.rBurst
+  rDataQ.io.deq.ready := io.axi.r.ready && rRespQ.io.deq.valid
 
   // ==================== Write Data Queue ====================
-  wDataQueue.io.enq.valid := io.axi.w.valid && (wState === WState.wBurst)
+  wDataQueue.io.enq.valid := io.axi.w.valid && io.axi.w.ready
   wDataQueue.io.enq.bits.data := io.axi.w.bits.data
   wDataQueue.io.enq.bits.strb := io.axi.w.bits.strb
   wDataQueue.io.deq.ready := grantWrite && io.ram.accept
 
+  io.debug.rDataCount := rDataQ.io.count
+  io.debug.wDataCount := wDataQueue.io.count
+  io.debug.arCount := arQ.io.count
+  io.debug.awCount := awQ.io.count
+  io.debug.rArbLoss := rReqRam && grantWrite
+  io.debug.wArbLoss := wReqRam && grantRead
+  io.debug.rTurnaround := rReqRam && wAckPending =/= 0.U
+  io.debug.wTurnaround := wReqRam && rAckPending =/= 0.U
+
   // ==================== AXI Read Response ====================
-  io.axi.r.valid := rDataQ.io.deq.valid && rState === RState.rBurst
+  io.axi.r.valid := rDataQ.io.deq.valid && rRespQ.io.deq.valid
   io.axi.r.bits.data := rDataQ.io.deq.bits
   io.axi.r.bits.resp := 0.U
-  io.axi.r.bits.id := rId // same id in one burst
-  io.axi.r.bits.last := rRespCnt === 0.U
+  io.axi.r.bits.id := rRespQ.io.deq.bits.id // same id in one burst
+  io.axi.r.bits.last := rRespCnt === rRespQ.io.deq.bits.len
 
   // ==================== AXI Write/Other Defaults ====================
-  io.axi.ar.ready := rState === RState.rIdle
-  io.axi.aw.ready := wState === WState.wIdle
-  io.axi.w.ready := false.B
-  io.axi.b.valid := false.B
+  val rBusy = !rAllReqsSent || rRespQ.io.deq.valid || arQ.io.count =/= 0.U
+  io.axi.ar.ready := arQ.io.enq.ready && (if (AR_DEPTH > 0) true.B else !rBusy)
+  val wBusy = !wAllReqsSent || wRespQ.io.deq.valid || awQ.io.count =/= 0.U
+  io.axi.aw.ready := awQ.io.enq.ready && (if (AW_DEPTH > 0) true.B else !wBusy)
+  // Data may run ahead of its AW when bursts are queued
+  io.axi.w.ready := wDataQueue.io.enq.ready && (if (AW_DEPTH > 0) true.B else !wAllReqsSent)
   io.axi.b.bits.resp := 0.U
-  io.axi.b.bits.id := wId
 
   // ==================== Read FSM Logic ====================
-  switch(rState) {
-    is(RState.rIdle) {
-      when(io.axi.ar.fire) {
-        rAddr := io.axi.ar.bits.addr // latch
-        rId := io.axi.ar.bits.id
-        rBurstType := io.axi.ar.bits.burst
-        rBurstLen := io.axi.ar.bits.len
-        rReqCnt := io.axi.ar.bits.len // counter
-        rRespCnt := io.axi.ar.bits.len
-        rAllReqsSent := false.B
-        rState := RState.rBurst
-      }
-    }
-    is(RState.rBurst) {
-      when(grantRead && io.ram.accept) { // pop from queue
-        when(rReqCnt === 0.U) {
-          rAllReqsSent := true.B
-        }.otherwise {
-          rReqCnt := rReqCnt - 1.U
-          rAddr := calculateAddrNext(rAddr, rBurstType, rBurstLen)
-        }
-      }
+  arQ.io.enq.valid := io.axi.ar.valid && io.axi.ar.ready
+  arQ.io.enq.bits.addr := io.axi.ar.bits.addr
+  arQ.io.enq.bits.id := io.axi.ar.bits.id
+  arQ.io.enq.bits.burst := io.axi.ar.bits.burst
+  arQ.io.enq.bits.len := io.axi.ar.bits.len
 
-      when(io.axi.r.fire) {
-        when(rRespCnt === 0.U) {
-          rState := RState.rIdle
-        }.otherwise {
-          rRespCnt := rRespCnt - 1.U
-        }
-      }
+  // Issue: load the next burst once the current one is fully requested
+  val rLastReq = grantRead && io.ram.accept && rReqCnt === 0.U
+  val rLoad = (rAllReqsSent || rLastReq) && arQ.io.deq.valid && rRespQ.io.enq.ready
+  arQ.io.deq.ready := rLoad
+  rRespQ.io.enq.valid := rLoad
+  rRespQ.io.enq.bits.id := arQ.io.deq.bits.id
+  rRespQ.io.enq.bits.len := arQ.io.deq.bits.len
+
+  when(rLoad) {
+    rAddr := arQ.io.deq.bits.addr // latch
+    rBurstType := arQ.io.deq.bits.burst
+    rBurstLen := arQ.io.deq.bits.len
+    rReqCnt := arQ.io.deq.bits.len // counter
+    rAllReqsSent := false.B
+  }.elsewhen(grantRead && io.ram.accept) { // pop from queue
+    when(rReqCnt === 0.U) {
+      rAllReqsSent := true.B
+    }.otherwise {
+      rReqCnt := rReqCnt - 1.U
+      rAddr := calculateAddrNext(rAddr, rBurstType, rBurstLen)
     }
   }
 
+  // Response: beats of the oldest issued burst
+  rRespQ.io.deq.ready := io.axi.r.fire && io.axi.r.bits.last
+  when(io.axi.r.fire) {
+    rRespCnt := Mux(io.axi.r.bits.last, 0.U, rRespCnt + 1.U)
+  }
+
   // ==================== Write FSM Logic ====================
-  switch(wState) {
-    is(WState.wIdle) {
-      when(io.axi.aw.fire) {
-        wAddr := io.axi.aw.bits.addr
-        wId := io.axi.aw.bits.id
-        wBurstType := io.axi.aw.bits.burst
-        wBurstLen := io.axi.aw.bits.len
-        wReqCnt := io.axi.aw.bits.len
-        wAllReqsSent := false.B
-        wState := WState.wBurst
-      }
-    }
-    is(WState.wBurst) {
-      io.axi.w.ready := wDataQueue.io.enq.ready
-
-      when(wDataQueue.io.deq.fire) {
-        when(wReqCnt === 0.U) {
-          wAllReqsSent := true.B
-        }.otherwise {
-          wReqCnt := wReqCnt - 1.U
-          wAddr := calculateAddrNext(wAddr, wBurstType, wBurstLen)
-        }
-      }
+  awQ.io.enq.valid := io.axi.aw.valid && io.axi.aw.ready
+  awQ.io.enq.bits.addr := io.axi.aw.bits.addr
+  awQ.io.enq.bits.id := io.axi.aw.bits.id
+  awQ.io.enq.bits.burst := io.axi.aw.bits.burst
+  awQ.io.enq.bits.len := io.axi.aw.bits.len
 
-      when(wAllReqsSent && wAckPending === 0.U) {
-        wState := WState.wResp
-      }
-    }
-    is(WState.wResp) {
-      io.axi.b.valid := true.B
-      when(io.axi.b.fire) {
-        wState := WState.wIdle
-      }
+  // Issue: load the next burst once the current one is fully requested
+  val wLastReq = grantWrite && io.ram.accept && wReqCnt === 0.U
+  val wLoad = (wAllReqsSent || wLastReq) && awQ.io.deq.valid && wRespQ.io.enq.ready
+  awQ.io.deq.ready := wLoad
+  wRespQ.io.enq.valid := wLoad
+  wRespQ.io.enq.bits.id := awQ.io.deq.bits.id
+  wRespQ.io.enq.bits.len := awQ.io.deq.bits.len
+
+  when(wLoad) {
+    wAddr := awQ.io.deq.bits.addr
+    wBurstType := awQ.io.deq.bits.burst
+    wBurstLen := awQ.io.deq.bits.len
+    wReqCnt := awQ.io.deq.bits.len
+    wAllReqsSent := false.B
+  }.elsewhen(wDataQueue.io.deq.fire) {
+    when(wReqCnt === 0.U) {
+      wAllReqsSent := true.B
+    }.otherwise {
+      wReqCnt := wReqCnt - 1.U
+      wAddr := calculateAddrNext(wAddr, wBurstType, wBurstLen)
     }
   }
+
+  // Response: B once every request of the oldest burst is acked (acks
+  // return in issue order)
+  io.axi.b.valid := wRespQ.io.deq.valid && wAcked > wRespQ.io.deq.bits.len
+  io.axi.b.bits.id := wRespQ.io.deq.bits.id
+  wRespQ.io.deq.ready := io.axi.b.fire
+  wAcked := wAcked + ackToWrite.asUInt -
+    Mux(io.axi.b.fire, wRespQ.io.deq.bits.len +& 1.U, 0.U)
 }
@@ -4,19 +4,30 @@ import chisel3._
 import chisel3.util._
 import chisel3.experimental.Analog
 
+// Internal state, for the testbench monitors
+class CoreDebugIO extends Bundle {
+  val state = UInt(4.W)
+  val targetState = UInt(4.W)
+  val delayState = UInt(4.W)
+  val refresh = Bool() // refreshQ
+  val refreshOwed = UInt(4.W) // refreshes due but not issued
+  val bankWait = Bool() // queue head waiting for its bank (ACT / PRE, tRCD)
+}
+
 class SdramCoreIO(val p: SdramParams) extends Bundle {
-  val inportWr = Input(UInt(4.W)) // strb
+  val inportWr = Input(UInt(p.wordBytes.W)) // strb
   val inportRd = Input(Bool())
   val inportLen = Input(UInt(8.W)) // burst len = 0
   val inportAddr = Input(UInt(32.W))
-  val inportWriteData = Input(UInt(32.W))
+  val inportWriteData = Input(UInt((8 * p.wordBytes).W))
 
   val inportAccept = Output(Bool())
   val inportAck = Output(Bool())
   val inportError = Output(Bool())
-  val inportReadData = Output(UInt(32.W))
+  val inportReadData = Output(UInt((8 * p.wordBytes).W))
 
   val sdram = new SDRAMIO(p)
+  val debug = Output(new CoreDebugIO)
 }
 
 class SdramCore(val p: SdramParams = SdramParams()) extends Module {
@@ -34,32 +45,86 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
   val CMD_REFRESH = "b0001".U(CMD_W.W)
   val CMD_LOAD_MODE = "b0000".U(CMD_W.W)
 
-  // Mode: Burst Length = 2 (sequential), CAS=2
-  // {3'b000, 1'b0, 2'b00, 3'b010, 1'b0, 3'b001} = 13'h0021
-  val MODE_REG = "h0021".U(p.rowW.W)
+  // Mode: Burst Length = p.burstLen (sequential), CAS = p.casLatency
+  // {3'b000, 1'b0, 2'b00, CL[2:0], 1'b0, BL[2:0]}, 13'h0021 for CL2 BL2
+  require(Seq(2, 4, 8).contains(p.burstLen), "burstLen must be 2, 4 or 8")
+  val MODE_REG = ((p.casLatency << 4) | log2Ceil(p.burstLen)).U(p.rowW.W)
+
+  // Words per READ / WRITE (two device beats each); the device is
+  // p.lanes chips wide
+  val BURST_WORDS = p.burstLen / 2
+  val BURST_W = log2Ceil(BURST_WORDS).max(1)
+  val DEV_W = p.dataW * p.lanes
+  val DQM_W = p.dqmW * p.lanes
+  val WORD_SHIFT = log2Ceil(p.wordBytes)
 
   val AUTO_PRECHARGE = 10
   val ALL_BANKS = 10
 
-  val DELAY_W = 4
+  // Wide enough for the longest timing at p.mhz
+  val DELAY_W = log2Ceil(
+    Seq(p.trfcCycles, p.trasCycles, p.trpCycles, p.trcdCycles,
+      1 + p.twrCycles, p.casLatency).max + 1).max(4)
   val REFRESH_CNT_W = log2Ceil(p.startDelay + 101) + 1
 
-  // --- External interface aliases (RamIO) ---
-  val ramAddrW = io.inportAddr
-  val ramWrW = io.inportWr
-  val ramRdW = io.inportRd
-  val ramWriteDataW = io.inportWriteData
+  // --- Request queue ---
+  // Accepted requests wait here; the state machine serves the head and
+  // the bank scheduler looks one entry further. An empty queue passes
+  // the bus request straight through.
+  class CoreReq extends Bundle {
+    val addr = UInt(32.W)
+    val wr = UInt(p.wordBytes.W)
+    val rd = Bool()
+    val data = UInt((8 * p.wordBytes).W)
+  }
+  val QUEUE_DEPTH = p.coreQueueDepth.max(1)
+
+  val inReqW = Wire(new CoreReq)
+  inReqW.addr := io.inportAddr
+  inReqW.wr := io.inportWr
+  inReqW.rd := io.inportRd
+  inReqW.data := io.inportWriteData
+  val inValidW = io.inportRd || io.inportWr =/= 0.U
+
+  val queueQ = Reg(Vec(QUEUE_DEPTH, new CoreReq))
+  val countQ = RegInit(0.U(log2Ceil(QUEUE_DEPTH + 1).W))
+  val headW = Mux(countQ === 0.U, inReqW, queueQ(0))
+  val nextW = if (QUEUE_DEPTH > 1) Mux(countQ <= 1.U, inReqW, queueQ(1)) else inReqW
+  val nextValidW = countQ >= 2.U || (countQ === 1.U && inValidW)
+  // State machine takes the head (READ / WRITE slot)
+  val takeW = WireDefault(false.B)
+
+  // --- External interface aliases (RamIO), the queue head ---
+  val ramAddrW = headW.addr
+  val ramWrW = headW.wr
+  val ramRdW = headW.rd
+  val ramWriteDataW = headW.data
   val ramReqW = ramWrW =/= 0.U || ramRdW
 
   // --- Address bit extraction ---
-  val addrColW = Cat(0.U((p.rowW - p.colW).W), ramAddrW(p.colW, 2), 0.U(1.W))
-  val addrRowW = ramAddrW(p.addrW, p.colW + 3)
-  val addrBankW = ramAddrW(p.colW + 2, p.colW + 1)
-
-   // States
+  // row | bank | col, or bank | row | col; a word is two columns, so
+  // col = addr(colW - 2 + WORD_SHIFT, WORD_SHIFT) either way
+  val COL_MSB = p.colW - 2 + WORD_SHIFT
+  val ROW_LSB = if (p.bankRowCol) COL_MSB + 1 else COL_MSB + 1 + p.bankW
+  val BANK_LSB = if (p.bankRowCol) COL_MSB + 1 + p.rowW else COL_MSB + 1
+  def rowOf(addr: UInt): UInt = addr(ROW_LSB + p.rowW - 1, ROW_LSB)
+  def bankOf(addr: UInt): UInt = {
+    val bank = addr(BANK_LSB + p.bankW - 1, BANK_LSB)
+    if (p.bankXor) bank ^ rowOf(addr)(p.bankW - 1, 0) else bank
+  }
+  def colOf(addr: UInt): UInt =
+    Cat(0.U((p.rowW - p.colW).W), addr(COL_MSB, WORD_SHIFT), 0.U(1.W))
+  val addrColW = colOf(ramAddrW)
+  val addrRowW = rowOf(ramAddrW)
+  val addrBankW = bankOf(ramAddrW)
+
+  // States (activate is no longer entered, the bank scheduler opens
+  // rows; kept so the numbering seen by the testbench is unchanged)
   object State extends ChiselEnum {
     //   0      1     2       3       4        5        6       7        8         9
-    val init, delay, idle, activate, read, read_wait, write0, write1, precharge, refresh = Value
+    val init, delay, idle, activate, read, read_wait, write0, write1, precharge, refresh,
+    //   10          11
+      read_burst, write_burst = Value
   }
 
   // --- state machine ---
@@ -69,45 +134,112 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
   val delayQ = RegInit(0.U(DELAY_W.W))
 
   // --- outputs: sdram ---
-  val commandW = WireInit(CMD_NOP); val commandQ = RegNext(commandW, CMD_INHIBIT)
+  // State machine command, or the bank scheduler's ACT / PRE when the
+  // state machine leaves the command bus idle
+  val commandW = WireInit(CMD_NOP); val bankCmdW = WireInit(CMD_NOP)
+  val commandQ = RegNext(Mux(bankCmdW =/= CMD_NOP, bankCmdW, commandW), CMD_INHIBIT)
   io.sdram.cs := commandQ(3)
   io.sdram.ras := commandQ(2)
   io.sdram.cas := commandQ(1)
   io.sdram.we := commandQ(0)
-  val dqmW = WireInit("b11".U(p.dqmW.W)); val dqmQ = RegNext(dqmW); io.sdram.dqm := dqmQ
+  val dqmW = WireInit(Fill(DQM_W, 1.U(1.W))); val dqmQ = RegNext(dqmW); io.sdram.dqm := dqmQ
   val addrQ = RegInit(0.U(p.rowW.W)); io.sdram.addr := addrQ
   val bankQ = RegInit(0.U(p.bankW.W)); io.sdram.ba := bankQ
-  val dataOutQ = RegInit(0.U(p.dataW.W));
+  val dataOutQ = RegInit(0.U(DEV_W.W));
   val ckeQ = RegInit(false.B); io.sdram.cke := ckeQ
-  // --- tri-state ---
+  // --- tri-state, one per chip (lane 0 low) ---
   val sdram_dq = IO(Analog(p.dataW.W))
-  val dataInW = TriStateInBuf(sdram_dq, dataOutQ, RegNext( stateQ === State.write0 || stateQ === State.write1 ))
-
-  // --- outputs: bus ---
-  io.inportAccept := (stateQ === State.read && ramRdW) ||
-    (stateQ === State.write0 && (ramWrW =/= 0.U))
-  io.inportError := false.B
+  val sdram_dq_hi =
+    if (p.lanes > 1) Some(IO(Analog(p.dataW.W)).suggestName("sdram_dq_hi")) else None
+  val dqOutEnW = RegNext(
+    stateQ === State.write0 || stateQ === State.write1 || stateQ === State.write_burst)
+  val dataInW = Cat((Seq(sdram_dq) ++ sdram_dq_hi).zipWithIndex.reverse.map {
+    case (dq, lane) =>
+      TriStateInBuf(dq, dataOutQ(p.dataW * (lane + 1) - 1, p.dataW * lane), dqOutEnW)
+  })
 
   // --- latched request address (stable across state transitions) ---
   val reqAddrQ = RegInit(0.U(32.W))
-  val reqWrStrbQ = RegInit("b1111".U(4.W))
-  val reqColW = Cat(0.U((p.rowW - p.colW).W), reqAddrQ(p.colW, 2), 0.U(1.W))
-  val reqRowW = reqAddrQ(p.addrW, p.colW + 3)
-  val reqBankW = reqAddrQ(p.colW + 2, p.colW + 1)
+  val reqWrStrbQ = RegInit(Fill(p.wordBytes, 1.U(1.W)))
+  val reqColW = colOf(reqAddrQ)
+  val reqBankW = bankOf(reqAddrQ)
 
   // --- row open ---
   val rowOpenQ = RegInit(0.U(p.banks.W))
   val activeRowQ = RegInit(VecInit(Seq.fill(p.banks)(0.U(p.rowW.W))))
-  val rowHitW = rowOpenQ(addrBankW) && addrRowW === activeRowQ(addrBankW)
+  def rowHit(addr: UInt): Bool =
+    rowOpenQ(bankOf(addr)) && rowOf(addr) === activeRowQ(bankOf(addr))
+  val rowHitW = rowHit(ramAddrW)
+
+  // --- per bank timers (cycles until the command is allowed) ---
+  def bankTimer() = RegInit(VecInit(Seq.fill(p.banks)(0.U(DELAY_W.W))))
+  val colWaitQ = bankTimer() // ACT -> READ / WRITE (tRCD)
+  val actWaitQ = bankTimer() // PRE -> ACT (tRP)
+  val preWaitQ = bankTimer() // ACT -> PRE (tRAS), READ / WRITE -> PRE
+  val rrdWaitQ = RegInit(0.U(DELAY_W.W)) // ACT -> ACT, any bank (tRRD)
+  for (b <- 0 until p.banks) {
+    when(colWaitQ(b) =/= 0.U) { colWaitQ(b) := colWaitQ(b) - 1.U }
+    when(actWaitQ(b) =/= 0.U) { actWaitQ(b) := actWaitQ(b) - 1.U }
+    when(preWaitQ(b) =/= 0.U) { preWaitQ(b) := preWaitQ(b) - 1.U }
+  }
+  when(rrdWaitQ =/= 0.U) { rrdWaitQ := rrdWaitQ - 1.U }
+
+  // Head row open and past tRCD: READ / WRITE now (or, from idle, next cycle)
+  val bankReadyW = rowHitW && colWaitQ(addrBankW) === 0.U
+  val bankSoonW = rowHitW && colWaitQ(addrBankW) <= 1.U
+
+  // --- native burst: words the last READ / WRITE still has to come ---
+  val burstLeftQ = RegInit(0.U(BURST_W.W))
+  // Next word of the running burst (its column block, so its row)
+  val burstNextW = burstLeftQ =/= 0.U &&
+    ramAddrW(31, WORD_SHIFT) === reqAddrQ(31, WORD_SHIFT) + 1.U
+  // read_burst / write_burst cycles without an accept
+  val lingerQ = RegInit(0.U(DELAY_W.W))
 
   // --- Periodic refresh (after init) ---
+  // Every tick owes one REFRESH. Owed ones wait while requests are queued
+  // and catch up (back to back) once the core has been quiet for a few
+  // cycles; refreshPostpone owed forces one regardless.
+  val REFRESH_QUIET = 4
   val (_, refreshTick) = Counter(stateQ =/= State.init, p.refreshCycles + 1)
+  val refreshOwedQ = RegInit(0.U(4.W))
+  val refreshDoneW = stateQ === State.refresh
+  val owedNextW = refreshOwedQ + refreshTick.asUInt - refreshDoneW.asUInt
+  refreshOwedQ := owedNextW
+
+  val quietQ = RegInit(0.U(log2Ceil(REFRESH_QUIET + 1).W))
+  when(ramReqW) {
+    quietQ := 0.U
+  }.elsewhen(quietQ =/= REFRESH_QUIET.U) {
+    quietQ := quietQ + 1.U
+  }
+
   val refreshQ = RegInit(false.B)
-  when(refreshTick) {
-    refreshQ := true.B
-  }.elsewhen(stateQ === State.refresh) {
-    refreshQ := false.B
+  refreshQ := owedNextW >= p.refreshPostpone.max(1).U ||
+    (owedNextW =/= 0.U && quietQ === REFRESH_QUIET.U && !ramReqW)
+
+  // read_burst / write_burst: ready row hits are taken straight away
+  val streamW = !refreshQ && bankReadyW
+  takeW := (stateQ === State.read && ramRdW) ||
+    (stateQ === State.write0 && (ramWrW =/= 0.U)) ||
+    (stateQ === State.read_burst && ramRdW && streamW) ||
+    (stateQ === State.write_burst && (ramWrW =/= 0.U) && streamW)
+
+  // --- outputs: bus ---
+  io.inportAccept := inValidW && (countQ < QUEUE_DEPTH.U || takeW)
+  io.inportError := false.B
+
+  // --- queue update ---
+  val popW = takeW && countQ =/= 0.U
+  // Empty queue and taken at once: not stored
+  val pushW = io.inportAccept && !(countQ === 0.U && takeW)
+  when(popW) {
+    for (i <- 0 until QUEUE_DEPTH - 1) { queueQ(i) := queueQ(i + 1) }
+  }
+  when(pushW) {
+    queueQ(Mux(popW, countQ - 1.U, countQ)) := inReqW
   }
+  countQ := countQ + pushW.asUInt - popW.asUInt
 
   // base(pos) = value
   def withBit(base: UInt, pos: Int, value: Bool): UInt = {
@@ -126,6 +258,16 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
     delayQ := cycles.U
   }
 
+  // PRE no sooner than cycles after this READ / WRITE slot (burst data
+  // still on the bus, write recovery)
+  def atLeast(timer: UInt, cycles: Int): Unit = {
+    when(timer <= cycles.U) { timer := cycles.U }
+  }
+
+  // Words left in the BL block after the word at addr
+  def burstLeft(addr: UInt): UInt =
+    if (BURST_WORDS > 1) ~addr(BURST_W + WORD_SHIFT - 1, WORD_SHIFT) else 0.U(BURST_W.W)
+
   // --- State Machine ---
   switch(stateQ) {
     is(State.init) {
@@ -150,37 +292,24 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
       }
     }
 
+    // Serve the head once the bank scheduler has its row open
     is(State.idle) {
+      targetStateQ := State.idle
       when(refreshQ) { // refresh come first
-        when(rowOpenQ.orR) { stateQ := State.precharge }
-          .otherwise        { stateQ := State.refresh }
+        // Banks past tRAS / write recovery, and tRP of the last PRE
+        when(rowOpenQ.orR) {
+          when(preWaitQ.asUInt === 0.U) { stateQ := State.precharge }
+        }.elsewhen(actWaitQ.asUInt === 0.U) {
+          stateQ := State.refresh
+        }
         targetStateQ := State.refresh
-      }.elsewhen(ramReqW) {
+      }.elsewhen(ramReqW && bankSoonW) {
         reqAddrQ := ramAddrW
         reqWrStrbQ := ramWrW
-        when(rowOpenQ(addrBankW) && addrRowW === activeRowQ(addrBankW)) {
-          stateQ := Mux(ramRdW, State.read, State.write0)
-        }.elsewhen(rowOpenQ(addrBankW)) {
-          stateQ := State.precharge
-          targetStateQ := Mux(ramRdW, State.read, State.write0)
-        }.otherwise {
-          stateQ := State.activate
-          targetStateQ := Mux(ramRdW, State.read, State.write0)
-        }
+        stateQ := Mux(ramRdW, State.read, State.write0)
       }
     }
 
-    is(State.activate) {
-      gotoDelay(targetStateQ, p.trcdCycles) // read/write
-
-      commandW := CMD_ACTIVE
-      addrQ := reqRowW
-      bankQ := reqBankW
-
-      activeRowQ(reqBankW) := reqRowW
-      rowOpenQ := rowOpenQ | (1.U << reqBankW)
-    }
-
     is(State.read) {
       stateQ := State.read_wait
 
@@ -188,16 +317,53 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
       addrQ := withBit(reqColW, AUTO_PRECHARGE, false.B)
       bankQ := reqBankW
       dqmW := 0.U
+      burstLeftQ := burstLeft(reqAddrQ)
+      lingerQ := 0.U
+      atLeast(preWaitQ(reqBankW), 1)
     }
 
     is(State.read_wait) {
       commandW := CMD_NOP
+      stateQ := State.read_burst
+    }
 
-      gotoDelay(State.idle, p.casLatency) // default
-      when(!refreshQ && ramReqW && ramRdW) { // burst from axi4
-        when(rowHitW) {
-          reqAddrQ := ramAddrW
-          stateQ := State.read // renew state instead of delay
+    // Row open for reads: the next word of the burst is already on its
+    // way, any other ready row hit (any bank) gets a new READ. Stays while
+    // the bus is quiet or the next read waits for its bank.
+    is(State.read_burst) {
+      when(ramRdW && streamW) {
+        stateQ := State.read_wait
+        reqAddrQ := ramAddrW
+        dqmW := 0.U
+        lingerQ := 0.U
+        atLeast(preWaitQ(addrBankW), 1)
+        when(burstNextW) {
+          burstLeftQ := burstLeftQ - 1.U
+        }.otherwise {
+          commandW := CMD_READ
+          addrQ := withBit(addrColW, AUTO_PRECHARGE, false.B)
+          bankQ := addrBankW
+          burstLeftQ := burstLeft(ramAddrW)
+        }
+      }.otherwise {
+        // Stop the rest of the burst (last word ends CL - 1 later)
+        when(burstLeftQ =/= 0.U) {
+          commandW := CMD_TERMINATE
+          burstLeftQ := 0.U
+        }
+        when(lingerQ =/= ~0.U(DELAY_W.W)) {
+          lingerQ := lingerQ + 1.U
+        }
+        // Leave for refresh or a write; the read data must be off the bus
+        // (CAS latency from the last READ slot) before idle
+        when(refreshQ || ramWrW =/= 0.U) {
+          when(lingerQ >= (p.casLatency - 1).U) {
+            stateQ := State.idle
+          }.otherwise {
+            stateQ := State.delay
+            delayStateQ := State.idle
+            delayQ := (p.casLatency - 1).U - lingerQ
+          }
         }
       }
     }
@@ -208,40 +374,58 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
       commandW := CMD_WRITE
       addrQ := withBit(reqColW, AUTO_PRECHARGE, false.B)
       bankQ := reqBankW
-      dataOutQ := ramWriteDataW(15, 0)
-      dqmW := ~reqWrStrbQ(1, 0)
+      dataOutQ := ramWriteDataW(DEV_W - 1, 0)
+      dqmW := ~reqWrStrbQ(DQM_W - 1, 0)
+      burstLeftQ := burstLeft(reqAddrQ)
+      atLeast(preWaitQ(reqBankW), 1 + p.twrCycles)
     }
 
     is(State.write1) {
-      stateQ := State.idle
-      when(!refreshQ && ramReqW && (ramWrW =/= 0.U)) {
-        when(rowHitW) {
-          reqAddrQ := ramAddrW
-          reqWrStrbQ := ramWrW
-          stateQ := State.write0
-        }
-      }
+      stateQ := State.write_burst
 
-      dataOutQ := RegNext(ramWriteDataW(31, 16))
+      dataOutQ := RegNext(ramWriteDataW(2 * DEV_W - 1, DEV_W))
       // bankQ := bankQ
       addrQ := withBit(addrQ, AUTO_PRECHARGE, false.B)
-      dqmW := ~reqWrStrbQ(3, 2)
+      dqmW := ~reqWrStrbQ(2 * DQM_W - 1, DQM_W)
     }
 
-    is(State.precharge) {
-      commandW := CMD_PRECHARGE
-      when(targetStateQ === State.refresh) {
-        gotoDelay(State.refresh, p.trpCycles)
-        addrQ := withBit(0.U(p.rowW.W), ALL_BANKS, true.B)
-        rowOpenQ := 0.U
+    // Row open for writes, as read_burst
+    is(State.write_burst) {
+      when((ramWrW =/= 0.U) && streamW) {
+        stateQ := State.write1
+        reqAddrQ := ramAddrW
+        reqWrStrbQ := ramWrW
+        dataOutQ := ramWriteDataW(DEV_W - 1, 0)
+        dqmW := ~ramWrW(DQM_W - 1, 0)
+        atLeast(preWaitQ(addrBankW), 1 + p.twrCycles)
+        when(burstNextW) {
+          burstLeftQ := burstLeftQ - 1.U
+        }.otherwise {
+          commandW := CMD_WRITE
+          addrQ := withBit(addrColW, AUTO_PRECHARGE, false.B)
+          bankQ := addrBankW
+          burstLeftQ := burstLeft(ramAddrW)
+        }
       }.otherwise {
-        gotoDelay(State.activate, p.trpCycles)
-        addrQ := withBit(0.U(p.rowW.W), ALL_BANKS, false.B)
-        bankQ := reqBankW
-        rowOpenQ := rowOpenQ & ~(1.U << reqBankW)
+        // Stop the burst before it writes the next column
+        when(burstLeftQ =/= 0.U) {
+          commandW := CMD_TERMINATE
+          burstLeftQ := 0.U
+        }
+        when(refreshQ || ramRdW) {
+          stateQ := State.idle
+        }
       }
     }
 
+    // All banks, for refresh (row conflicts are the bank scheduler's)
+    is(State.precharge) {
+      commandW := CMD_PRECHARGE
+      gotoDelay(State.refresh, p.trpCycles)
+      addrQ := withBit(0.U(p.rowW.W), ALL_BANKS, true.B)
+      rowOpenQ := 0.U
+    }
+
     is(State.refresh) {
       gotoDelay(State.idle, p.trfcCycles)
 
@@ -254,11 +438,99 @@ class SdramCore(val p: SdramParams = SdramParams()) extends Module {
     }
   }
 
+  // --- Bank scheduler ---
+  // ACT / PRE in the command slots the state machine leaves idle (tRCD,
+  // tRP, CAS latency, burst beats): for the head if its row is not open,
+  // else for the next request on another bank, so its row is ready when
+  // it reaches the head; otherwise PRE a row the page policy closes.
+  // Stops while refresh is pending or running.
+  val refreshBusyW = refreshQ || stateQ === State.init ||
+    stateQ === State.precharge || stateQ === State.refresh ||
+    (stateQ === State.delay && targetStateQ === State.refresh)
+
+  // Row conflict: PRE once the bank allows it; closed: ACT after tRP
+  def prepReady(addr: UInt): Bool = {
+    val bank = bankOf(addr)
+    Mux(rowOpenQ(bank), preWaitQ(bank) === 0.U,
+      actWaitQ(bank) === 0.U && rrdWaitQ === 0.U)
+  }
+  val headPrepW = ramReqW && !rowHitW && prepReady(ramAddrW)
+  val nextPrepW = nextValidW && bankOf(nextW.addr) =/= addrBankW &&
+    !rowHit(nextW.addr) && prepReady(nextW.addr)
+
+  // --- Page policy ---
+  // Adaptive: 2-bit counter per bank, up when an access reuses the
+  // bank's previous row, down when it changes row; closes below 2
+  val lastRowQ = Reg(Vec(p.banks, UInt(p.rowW.W)))
+  val keepOpenQ = RegInit(VecInit(Seq.fill(p.banks)(2.U(2.W))))
+  when(takeW) {
+    val sameRowW = addrRowW === lastRowQ(addrBankW)
+    when(sameRowW && keepOpenQ(addrBankW) =/= 3.U) {
+      keepOpenQ(addrBankW) := keepOpenQ(addrBankW) + 1.U
+    }.elsewhen(!sameRowW && keepOpenQ(addrBankW) =/= 0.U) {
+      keepOpenQ(addrBankW) := keepOpenQ(addrBankW) - 1.U
+    }
+    lastRowQ(addrBankW) := addrRowW
+  }
+
+  // Open rows no queued request hits, past tRAS / the last burst
+  val closeW = Wire(Vec(p.banks, Bool()))
+  for (b <- 0 until p.banks) {
+    def hits(valid: Bool, addr: UInt): Bool =
+      valid && bankOf(addr) === b.U && rowOf(addr) === activeRowQ(b)
+    val queuedHitW = hits(ramReqW, ramAddrW) || hits(nextValidW, nextW.addr)
+    val policyW = p.pagePolicy match {
+      case 1 => true.B
+      case 2 => keepOpenQ(b) < 2.U
+      case _ => false.B
+    }
+    closeW(b) := rowOpenQ(b) && preWaitQ(b) === 0.U && !queuedHitW && policyW
+  }
+  val closeBankW = PriorityEncoder(closeW.asUInt)
+
+  val prepAddrW = Mux(headPrepW, ramAddrW, nextW.addr)
+  val prepBankW = bankOf(prepAddrW)
+  val prepRowW = rowOf(prepAddrW)
+  val slotFreeW = !refreshBusyW && commandW === CMD_NOP
+  when(slotFreeW && (headPrepW || nextPrepW)) {
+    bankQ := prepBankW
+    when(rowOpenQ(prepBankW)) {
+      bankCmdW := CMD_PRECHARGE
+      addrQ := withBit(0.U(p.rowW.W), ALL_BANKS, false.B)
+      rowOpenQ := rowOpenQ & ~(1.U << prepBankW)
+      actWaitQ(prepBankW) := p.trpCycles.U
+    }.otherwise {
+      bankCmdW := CMD_ACTIVE
+      addrQ := prepRowW
+      activeRowQ(prepBankW) := prepRowW
+      rowOpenQ := rowOpenQ | (1.U << prepBankW)
+      colWaitQ(prepBankW) := p.trcdCycles.U
+      preWaitQ(prepBankW) := p.trasCycles.U
+      rrdWaitQ := (p.trrdCycles - 1).max(0).U
+    }
+  }.elsewhen(slotFreeW && closeW.asUInt.orR) {
+    bankCmdW := CMD_PRECHARGE
+    bankQ := closeBankW
+    addrQ := withBit(0.U(p.rowW.W), ALL_BANKS, false.B)
+    rowOpenQ := rowOpenQ & ~(1.U << closeBankW)
+    actWaitQ(closeBankW) := p.trpCycles.U
+  }
+
   // --- Read data pipeline ---
-  val sampleDataQ = ShiftRegister(dataInW, 2, 0.U(p.dataW.W), true.B)
-  val rdDelayed = ShiftRegister(stateQ === State.read, p.casLatency + 2, false.B, true.B)
+  val sampleDataQ = ShiftRegister(dataInW, 2, 0.U(DEV_W.W), true.B)
+  // Acks follow the take at a fixed latency, however it was issued:
+  // the READ reaches the pins a clock after the take, data CL later
+  val rdDelayed = ShiftRegister(takeW && ramRdW, p.casLatency + 2, false.B, true.B)
+  val wrDelayed = RegNext(takeW && (ramWrW =/= 0.U), false.B)
   io.inportReadData := Cat(sampleDataQ, RegNext(sampleDataQ))
-  io.inportAck := RegNext( stateQ === State.write1 || rdDelayed )
+  io.inportAck := RegNext( wrDelayed || rdDelayed )
 
   io.sdram.clk := (~clock.asUInt)
+
+  io.debug.state := stateQ.asUInt
+  io.debug.targetState := targetStateQ.asUInt
+  io.debug.delayState := delayStateQ.asUInt
+  io.debug.refresh := refreshQ
+  io.debug.refreshOwed := refreshOwedQ
+  io.debug.bankWait := ramReqW && !bankReadyW
 }
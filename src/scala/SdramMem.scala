@@ -43,6 +43,7 @@ class SdramMemImpl extends Module with RequireAsyncReset {
   // --- settings ---
   private val writeBurstEnQ  = RegInit(false.B)
   private val burstLenQ = RegInit(0.U(3.W))
+  private val casLatencyQ = RegInit(2.U(3.W))
 
   // --- states ---
   private val activeRowQ   = RegInit(VecInit(Seq.fill(NUM_BANKS)(0.U(WIDTH_ROWS.W))))
@@ -50,6 +51,7 @@ class SdramMemImpl extends Module with RequireAsyncReset {
   private val burstReadCountQ = RegInit(0.U(3.W))
   private val burstWriteCountQ = RegInit(0.U(3.W))
   private val burstAddrQ = RegInit(0.U(32.W))
+  private val burstBankQ = RegInit(0.U(WIDTH_BANK.W))
 
   // --- SyncReadMem storage (replaces DPI-C sdram_cmd) ---
   private val mem = SyncReadMem(1 << ADDR_BITS, Vec(2, UInt(8.W)))
@@ -67,8 +69,11 @@ class SdramMemImpl extends Module with RequireAsyncReset {
   // --- output ---
   private val next_data_out_en = WireInit(false.B)
   private val data_out_en_reg = RegNext(next_data_out_en)
-  io.data_out_en := data_out_en_reg
-  io.data_output := Cat(memRdata(1), memRdata(0))
+  // The array read lands CL 2 after the READ; CL 3 holds it a clock more
+  private val cas3W = casLatencyQ === 3.U
+  private val readDataW = Cat(memRdata(1), memRdata(0))
+  io.data_out_en := Mux(cas3W, RegNext(data_out_en_reg, false.B), data_out_en_reg)
+  io.data_output := Mux(cas3W, RegNext(readDataW), readDataW)
 
   private def memRead(byteAddr: UInt): Unit = {
     memRdEn := true.B
@@ -95,10 +100,31 @@ class SdramMemImpl extends Module with RequireAsyncReset {
     ( !io.ras_n && !io.cas_n && io.we_n ) -> Command.refresh,
     ( !io.ras_n && !io.cas_n && !io.we_n ) -> Command.load_mode,
   ))
+  // Burst beats go on under NOP, and ACT / PRE to another bank; READ,
+  // WRITE, BST and PRE of the burst's bank (or all) end the burst
+  private val burstGoesOnW = commandW === Command.nop || commandW === Command.active ||
+    (commandW === Command.precharge && !io.addr(10) && io.ba =/= burstBankQ)
+  when(burstGoesOnW) {
+    when( burstReadCountQ > 0.U ) {
+      memRead(burstAddrQ)
+      next_data_out_en := true.B
+
+      burstReadCountQ := burstReadCountQ - 1.U
+      burstAddrQ := burstAddrQ + 2.U
+    }
+    when( burstWriteCountQ > 0.U ) {
+      memWrite(burstAddrQ, io.data_input, io.dqm_n)
+
+      burstWriteCountQ := burstWriteCountQ - 1.U
+      burstAddrQ := burstAddrQ + 2.U
+    }
+  }
+
   switch(commandW) {
     is(Command.load_mode) {
       writeBurstEnQ  := ! io.addr(9)
       burstLenQ := io.addr(2, 0)
+      casLatencyQ := io.addr(6, 4)
     }
     is(Command.refresh) {
       for (i <- 0 until NUM_BANKS) {
@@ -125,6 +151,7 @@ class SdramMemImpl extends Module with RequireAsyncReset {
 
       burstReadCountQ := (1.U << burstLenQ) - 1.U
       burstAddrQ := addrW + 2.U
+      burstBankQ := baW
     }
     is(Command.write) {
       val baW = io.ba
@@ -137,21 +164,7 @@ class SdramMemImpl extends Module with RequireAsyncReset {
 
       burstWriteCountQ := Mux( writeBurstEnQ, (1.U << burstLenQ) - 1.U, 0.U )
       burstAddrQ := addrW + 2.U
-    }
-    is(Command.nop) {
-      when( burstReadCountQ > 0.U ) {
-        memRead(burstAddrQ)
-        next_data_out_en := true.B
-
-        burstReadCountQ := burstReadCountQ - 1.U
-        burstAddrQ := burstAddrQ + 2.U
-      }
-      when( burstWriteCountQ > 0.U ) {
-        memWrite(burstAddrQ, io.data_input, io.dqm_n)
-
-        burstWriteCountQ := burstWriteCountQ - 1.U
-        burstAddrQ := burstAddrQ + 2.U
-      }
+      burstBankQ := baW
     }
     is(Command.burst_terminate) {
       burstReadCountQ := 0.U
@@ -167,6 +180,10 @@ class SdramMemImpl extends Module with RequireAsyncReset {
         val baW = io.ba
         activeEnRowQ(baW) := false.B
       }
+      when( all_banks || io.ba === burstBankQ ) {
+        burstReadCountQ := 0.U
+        burstWriteCountQ := 0.U
+      }
     }
   }
 }